@@ -0,0 +1,57 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <utility>
+
+#include "ForestWeights.h"
+
+namespace grf {
+
+ForestWeights::ForestWeights(size_t num_cols,
+                             std::vector<size_t>&& row_offsets,
+                             std::vector<size_t>&& columns,
+                             std::vector<double>&& values):
+    num_cols(num_cols),
+    row_offsets(std::move(row_offsets)),
+    columns(std::move(columns)),
+    values(std::move(values)) {}
+
+size_t ForestWeights::get_num_rows() const {
+  return row_offsets.size() - 1;
+}
+
+size_t ForestWeights::get_num_cols() const {
+  return num_cols;
+}
+
+size_t ForestWeights::get_num_nonzeros() const {
+  return values.size();
+}
+
+const std::vector<size_t>& ForestWeights::get_row_offsets() const {
+  return row_offsets;
+}
+
+const std::vector<size_t>& ForestWeights::get_columns() const {
+  return columns;
+}
+
+const std::vector<double>& ForestWeights::get_values() const {
+  return values;
+}
+
+} // namespace grf
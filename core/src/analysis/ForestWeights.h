@@ -0,0 +1,61 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_FORESTWEIGHTS_H
+#define GRF_FORESTWEIGHTS_H
+
+#include <cstddef>
+#include <vector>
+
+namespace grf {
+
+/**
+ * A matrix of forest weights in compressed sparse row format, with one row per
+ * test sample and one column per training sample.
+ *
+ * The entries of row i are stored at positions row_offsets[i] up to row_offsets[i + 1]
+ * of columns and values, sorted by column.
+ */
+class ForestWeights {
+public:
+  ForestWeights(size_t num_cols,
+                std::vector<size_t>&& row_offsets,
+                std::vector<size_t>&& columns,
+                std::vector<double>&& values);
+
+  size_t get_num_rows() const;
+
+  size_t get_num_cols() const;
+
+  size_t get_num_nonzeros() const;
+
+  const std::vector<size_t>& get_row_offsets() const;
+
+  const std::vector<size_t>& get_columns() const;
+
+  const std::vector<double>& get_values() const;
+
+private:
+  size_t num_cols;
+  std::vector<size_t> row_offsets;
+  std::vector<size_t> columns;
+  std::vector<double> values;
+};
+
+} // namespace grf
+
+#endif //GRF_FORESTWEIGHTS_H
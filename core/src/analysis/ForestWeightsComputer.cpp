@@ -0,0 +1,171 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <future>
+#include <stdexcept>
+
+#include "ForestWeightsComputer.h"
+#include "commons/utility.h"
+#include "prediction/collector/SampleWeightComputer.h"
+#include "prediction/collector/TreeTraverser.h"
+
+namespace grf {
+
+ForestWeightsComputer::ForestWeightsComputer(uint num_threads):
+    num_threads(num_threads) {}
+
+ForestWeights ForestWeightsComputer::compute(const Forest& forest,
+                                             const Data& train_data,
+                                             const Data& data,
+                                             bool oob_prediction) const {
+  // A row can never hold more weights than there are training samples.
+  return compute(forest, train_data, data, oob_prediction, train_data.get_num_rows());
+}
+
+ForestWeights ForestWeightsComputer::compute(const Forest& forest,
+                                             const Data& train_data,
+                                             const Data& data,
+                                             bool oob_prediction,
+                                             size_t max_weights_per_row) const {
+  if (max_weights_per_row == 0) {
+    throw std::runtime_error("The maximum number of weights per row must be positive.");
+  }
+
+  size_t num_samples = data.get_num_rows();
+  size_t num_train_samples = train_data.get_num_rows();
+  if (num_samples == 0) {
+    return ForestWeights(num_train_samples, std::vector<size_t>(1, 0), {}, {});
+  }
+
+  TreeTraverser tree_traverser(num_threads);
+  ValidTreesBySample valid_trees_by_sample = tree_traverser.get_valid_trees_by_sample(forest, data, oob_prediction);
+
+  std::vector<uint> thread_ranges;
+  split_sequence(thread_ranges, 0, static_cast<uint>(num_samples - 1), num_threads);
+
+  // First count the weights of each row, storing the count of row i in row_offsets[i + 1].
+  std::vector<size_t> row_offsets(num_samples + 1, 0);
+  std::vector<std::future<void>> futures;
+  futures.reserve(thread_ranges.size());
+  for (uint i = 0; i < thread_ranges.size() - 1; ++i) {
+    size_t start_index = thread_ranges[i];
+    size_t num_samples_batch = thread_ranges[i + 1] - start_index;
+    futures.push_back(std::async(std::launch::async,
+                                 &ForestWeightsComputer::count_batch,
+                                 this,
+                                 start_index,
+                                 num_samples_batch,
+                                 std::ref(forest),
+                                 std::ref(train_data),
+                                 std::ref(data),
+                                 std::ref(valid_trees_by_sample),
+                                 max_weights_per_row,
+                                 std::ref(row_offsets)));
+  }
+  for (auto& future : futures) {
+    future.get();
+  }
+
+  for (size_t sample = 0; sample < num_samples; ++sample) {
+    row_offsets[sample + 1] += row_offsets[sample];
+  }
+  size_t num_nonzeros = row_offsets[num_samples];
+  std::vector<size_t> columns(num_nonzeros);
+  std::vector<double> values(num_nonzeros);
+
+  // Then compute the weights, with each thread writing its rows into place.
+  futures.clear();
+  for (uint i = 0; i < thread_ranges.size() - 1; ++i) {
+    size_t start_index = thread_ranges[i];
+    size_t num_samples_batch = thread_ranges[i + 1] - start_index;
+    futures.push_back(std::async(std::launch::async,
+                                 &ForestWeightsComputer::compute_batch,
+                                 this,
+                                 start_index,
+                                 num_samples_batch,
+                                 std::ref(forest),
+                                 std::ref(train_data),
+                                 std::ref(data),
+                                 std::ref(valid_trees_by_sample),
+                                 max_weights_per_row,
+                                 std::cref(row_offsets),
+                                 std::ref(columns),
+                                 std::ref(values)));
+  }
+  for (auto& future : futures) {
+    future.get();
+  }
+
+  return ForestWeights(num_train_samples, std::move(row_offsets), std::move(columns), std::move(values));
+}
+
+void ForestWeightsComputer::count_batch(size_t start_sample,
+                                        size_t num_samples,
+                                        const Forest& forest,
+                                        const Data& train_data,
+                                        const Data& data,
+                                        const ValidTreesBySample& valid_trees_by_sample,
+                                        size_t max_weights_per_row,
+                                        std::vector<size_t>& row_offsets) const {
+  SampleWeightComputer weight_computer(train_data.get_num_rows());
+  for (size_t sample = start_sample; sample < start_sample + num_samples; ++sample) {
+    size_t num_weights = weight_computer.count_weights(sample, forest, data, valid_trees_by_sample);
+    row_offsets[sample + 1] = std::min(num_weights, max_weights_per_row);
+  }
+}
+
+void ForestWeightsComputer::compute_batch(size_t start_sample,
+                                          size_t num_samples,
+                                          const Forest& forest,
+                                          const Data& train_data,
+                                          const Data& data,
+                                          const ValidTreesBySample& valid_trees_by_sample,
+                                          size_t max_weights_per_row,
+                                          const std::vector<size_t>& row_offsets,
+                                          std::vector<size_t>& columns,
+                                          std::vector<double>& values) const {
+  SampleWeightComputer weight_computer(train_data.get_num_rows());
+
+  std::vector<std::pair<size_t, double>> weights;
+  for (size_t sample = start_sample; sample < start_sample + num_samples; ++sample) {
+    weight_computer.compute_weights(sample, forest, data, valid_trees_by_sample, weights);
+    if (weights.size() > max_weights_per_row) {
+      truncate_weights(weights, max_weights_per_row);
+    }
+
+    size_t offset = row_offsets[sample];
+    for (const auto& entry : weights) {
+      columns[offset] = entry.first;
+      values[offset] = entry.second;
+      ++offset;
+    }
+  }
+}
+
+void ForestWeightsComputer::truncate_weights(std::vector<std::pair<size_t, double>>& weights,
+                                             size_t max_weights) {
+  // Select the largest weights, preferring smaller sample IDs among equal weights.
+  std::nth_element(weights.begin(), weights.begin() + max_weights, weights.end(),
+                   [](const std::pair<size_t, double>& a, const std::pair<size_t, double>& b) {
+                     return a.second > b.second || (a.second == b.second && a.first < b.first);
+                   });
+  weights.resize(max_weights);
+  std::sort(weights.begin(), weights.end());
+}
+
+} // namespace grf
@@ -0,0 +1,94 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_FORESTWEIGHTSCOMPUTER_H
+#define GRF_FORESTWEIGHTSCOMPUTER_H
+
+#include <utility>
+#include <vector>
+
+#include "analysis/ForestWeights.h"
+#include "commons/Data.h"
+#include "forest/Forest.h"
+#include "prediction/collector/ValidTreesBySample.h"
+
+namespace grf {
+
+/**
+ * Computes the matrix of forest weights, where entry (i, j) is the weight the forest
+ * places on training sample j when predicting for test sample i.
+ *
+ * Test samples are split into contiguous blocks that are processed in parallel, each
+ * thread using its own SampleWeightComputer. A first pass counts the weights of every
+ * row, so that the CSR matrix can be allocated once and a second pass can write each
+ * block's weights directly into place. This traverses the trees twice, but keeps the
+ * peak memory at the size of the result rather than twice that.
+ *
+ * forest: the forest, which must have been trained with its leaf samples kept
+ * train_data: the data the forest was trained on
+ * data: the test samples
+ * oob_prediction: whether each test sample should only use trees for which it was
+ *   out-of-bag, in which case data must be the training data
+ * max_weights_per_row: if given, only this many largest weights of each row are
+ *   kept, with ties broken towards smaller sample IDs. The kept weights are not
+ *   renormalized, so such a row sums to at most one.
+ */
+class ForestWeightsComputer {
+public:
+  ForestWeightsComputer(uint num_threads);
+
+  ForestWeights compute(const Forest& forest,
+                        const Data& train_data,
+                        const Data& data,
+                        bool oob_prediction) const;
+
+  ForestWeights compute(const Forest& forest,
+                        const Data& train_data,
+                        const Data& data,
+                        bool oob_prediction,
+                        size_t max_weights_per_row) const;
+
+private:
+  void count_batch(size_t start_sample,
+                   size_t num_samples,
+                   const Forest& forest,
+                   const Data& train_data,
+                   const Data& data,
+                   const ValidTreesBySample& valid_trees_by_sample,
+                   size_t max_weights_per_row,
+                   std::vector<size_t>& row_offsets) const;
+
+  void compute_batch(size_t start_sample,
+                     size_t num_samples,
+                     const Forest& forest,
+                     const Data& train_data,
+                     const Data& data,
+                     const ValidTreesBySample& valid_trees_by_sample,
+                     size_t max_weights_per_row,
+                     const std::vector<size_t>& row_offsets,
+                     std::vector<size_t>& columns,
+                     std::vector<double>& values) const;
+
+  static void truncate_weights(std::vector<std::pair<size_t, double>>& weights,
+                               size_t max_weights);
+
+  uint num_threads;
+};
+
+} // namespace grf
+
+#endif //GRF_FORESTWEIGHTSCOMPUTER_H
@@ -0,0 +1,69 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <stdexcept>
+
+#include "analysis/LambdaPathErrorComputer.h"
+
+namespace grf {
+
+std::vector<double> LambdaPathErrorComputer::compute_regression_errors(const std::vector<Prediction>& predictions,
+                                                                       const Data& data) const {
+  return compute_errors(predictions, data, false);
+}
+
+std::vector<double> LambdaPathErrorComputer::compute_r_learner_errors(const std::vector<Prediction>& predictions,
+                                                                      const Data& data) const {
+  return compute_errors(predictions, data, true);
+}
+
+std::vector<double> LambdaPathErrorComputer::compute_errors(const std::vector<Prediction>& predictions,
+                                                            const Data& data,
+                                                            bool use_treatment) const {
+  if (predictions.size() != data.get_num_rows()) {
+    throw std::runtime_error("There must be one prediction per sample.");
+  }
+  if (predictions.empty()) {
+    return std::vector<double>();
+  }
+
+  size_t num_lambdas = predictions[0].size();
+  std::vector<double> errors(num_lambdas, 0.0);
+  std::vector<size_t> counts(num_lambdas, 0);
+
+  for (size_t sample = 0; sample < predictions.size(); ++sample) {
+    const std::vector<double>& path = predictions[sample].get_predictions();
+    double outcome = data.get_outcome(sample);
+    double treatment = use_treatment ? data.get_treatment(sample) : 1.0;
+    for (size_t i = 0; i < num_lambdas; ++i) {
+      if (std::isnan(path[i])) {
+        continue;
+      }
+      double residual = outcome - treatment * path[i];
+      errors[i] += residual * residual;
+      counts[i]++;
+    }
+  }
+
+  for (size_t i = 0; i < num_lambdas; ++i) {
+    errors[i] = counts[i] > 0 ? errors[i] / counts[i] : NAN;
+  }
+  return errors;
+}
+
+} // namespace grf
@@ -0,0 +1,60 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_LAMBDAPATHERRORCOMPUTER_H
+#define GRF_LAMBDAPATHERRORCOMPUTER_H
+
+#include <vector>
+
+#include "commons/Data.h"
+#include "prediction/Prediction.h"
+
+namespace grf {
+
+/**
+ * Computes the tuning criterion of each lambda on a local linear regularization path,
+ * from out-of-bag predictions with one value per lambda.
+ *
+ * Out-of-bag predictions never use the trees a sample was trained on, so these errors
+ * play the role of a leave-one-out criterion. Samples whose prediction is NaN (because
+ * they had no out-of-bag neighbors) are left out of the average.
+ */
+class LambdaPathErrorComputer {
+public:
+  /**
+   * The mean squared error (Y_i - prediction_i(lambda))^2 of each lambda.
+   */
+  std::vector<double> compute_regression_errors(const std::vector<Prediction>& predictions,
+                                                const Data& data) const;
+
+  /**
+   * The R-learner loss (Y_i - W_i * prediction_i(lambda))^2 of each lambda, averaged over
+   * samples. The outcome and treatment in data are expected to be centered by their
+   * conditional means already.
+   */
+  std::vector<double> compute_r_learner_errors(const std::vector<Prediction>& predictions,
+                                               const Data& data) const;
+
+private:
+  std::vector<double> compute_errors(const std::vector<Prediction>& predictions,
+                                     const Data& data,
+                                     bool use_treatment) const;
+};
+
+} // namespace grf
+
+#endif //GRF_LAMBDAPATHERRORCOMPUTER_H
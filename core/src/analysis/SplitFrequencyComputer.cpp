@@ -25,8 +25,6 @@ std::vector<std::vector<size_t>> SplitFrequencyComputer::compute(const Forest& f
   std::vector<std::vector<size_t>> result(max_depth, std::vector<size_t>(num_variables));
 
   for (const auto& tree : forest.get_trees()) {
-    const std::vector<std::vector<size_t>>& child_nodes = tree->get_child_nodes();
-
     size_t depth = 0;
     std::vector<size_t> level = {tree->get_root_node()};
 
@@ -38,11 +36,11 @@ std::vector<std::vector<size_t>> SplitFrequencyComputer::compute(const Forest& f
           continue;
         }
 
-        size_t variable = tree->get_split_vars().at(node);
+        size_t variable = tree->get_split_var(node);
         result[depth][variable]++;
 
-        next_level.push_back(child_nodes[0][node]);
-        next_level.push_back(child_nodes[1][node]);
+        next_level.push_back(tree->get_left_child(node));
+        next_level.push_back(tree->get_right_child(node));
       }
 
       level = next_level;
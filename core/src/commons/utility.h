@@ -18,6 +18,7 @@
 #ifndef GRF_UTILITY_H_
 #define GRF_UTILITY_H_
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -45,6 +46,22 @@ std::pair<std::vector<double>, std::vector<size_t>> load_data(const std::string&
 
 void set_data(std::pair<std::vector<double>, std::vector<size_t>>& data, size_t row, size_t col, double value);
 
+/**
+ * The index of the lowest set bit of a non-zero word.
+ */
+inline size_t count_trailing_zeros(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<size_t>(__builtin_ctzll(word));
+#else
+  size_t count = 0;
+  while ((word & 1) == 0) {
+    word >>= 1;
+    count++;
+  }
+  return count;
+#endif
+}
+
 } // namespace grf
 
 #endif /* GRF_UTILITY_H_ */
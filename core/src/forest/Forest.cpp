@@ -38,6 +38,7 @@ Forest::Forest(Forest&& forest) {
                      std::make_move_iterator(forest.trees.end()));
   this->num_variables = forest.num_variables;
   this->ci_group_size = forest.ci_group_size;
+  this->drawn_sample_regenerator = std::move(forest.drawn_sample_regenerator);
 }
 
 Forest Forest::merge(std::vector<Forest>& forests) {
@@ -54,6 +55,9 @@ Forest Forest::merge(std::vector<Forest>& forests) {
     if (forest.get_ci_group_size() != ci_group_size) {
       throw std::runtime_error("All forests being merged must have the same ci_group_size.");
     }
+    if (forest.get_drawn_sample_regenerator() != nullptr) {
+      throw std::runtime_error("Forests whose drawn samples have been discarded cannot be merged.");
+    }
   }
 
   return Forest(all_trees, num_variables, ci_group_size);
@@ -75,4 +79,23 @@ const size_t Forest::get_ci_group_size() const {
   return ci_group_size;
 }
 
+void Forest::discard_drawn_samples(const ForestOptions& options) {
+  for (const auto& tree : trees) {
+    if (!tree->has_drawn_samples_seed()) {
+      throw std::runtime_error("Drawn samples can only be discarded from trees that recorded their "
+                               "sampling seed during training, which deserialized trees do not.");
+    }
+  }
+
+  drawn_sample_regenerator.reset(new DrawnSampleRegenerator(
+      options.get_sampling_options(), options.get_sample_fraction(), ci_group_size));
+  for (auto& tree : trees) {
+    tree->discard_drawn_samples();
+  }
+}
+
+const DrawnSampleRegenerator* Forest::get_drawn_sample_regenerator() const {
+  return drawn_sample_regenerator.get();
+}
+
 } // namespace grf
@@ -21,6 +21,7 @@
 #include "commons/Data.h"
 #include "commons/globals.h"
 #include "forest/ForestOptions.h"
+#include "sampling/DrawnSampleRegenerator.h"
 #include "tree/TreeTrainer.h"
 #include "tree/Tree.h"
 
@@ -45,6 +46,23 @@ public:
   const size_t get_num_variables() const;
   const size_t get_ci_group_size() const;
 
+  /**
+   * Frees the drawn samples stored in every tree, keeping only each tree's seed.
+   * OOB predictions then regenerate the drawn samples on demand, which requires
+   * the same sampling options as the forest was trained with.
+   *
+   * This greatly reduces the size of forests that are kept around for OOB scoring.
+   * Throws if a tree did not record its seed during training, as is the case for
+   * deserialized trees. Forests whose drawn samples were discarded cannot be serialized.
+   */
+  void discard_drawn_samples(const ForestOptions& options);
+
+  /**
+   * The regenerator for the trees' drawn samples, or nullptr if the trees still
+   * store their drawn samples.
+   */
+  const DrawnSampleRegenerator* get_drawn_sample_regenerator() const;
+
   /**
    * Merges the given forests into a single forest. The new forest
    * will contain all the trees from the smaller forests.
@@ -58,6 +76,7 @@ private:
   std::vector<std::unique_ptr<Tree>> trees;
   size_t num_variables;
   size_t ci_group_size;
+  std::unique_ptr<DrawnSampleRegenerator> drawn_sample_regenerator;
   DISALLOW_COPY_AND_ASSIGN(Forest);
 };
 
@@ -0,0 +1,184 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+#include "forest/ForestCompiler.h"
+
+namespace grf {
+
+ForestCompiler::ForestCompiler(size_t num_types,
+                               size_t prediction_length,
+                               const std::string& prediction_code):
+    num_types(num_types),
+    prediction_length(prediction_length),
+    prediction_code(prediction_code) {}
+
+void ForestCompiler::compile(const Forest& forest, std::ostream& out) const {
+  const std::vector<std::unique_ptr<Tree>>& trees = forest.get_trees();
+
+  out << "// Generated by grf's ForestCompiler from a forest of " << trees.size() << " trees.\n"
+      << "// Compile without floating point contraction or fast-math to keep predictions exact.\n"
+      << "#include <cmath>\n"
+      << "#include <cstddef>\n"
+      << "\n"
+      << "namespace {\n"
+      << "\n"
+      << "const size_t NUM_TYPES = " << num_types << ";\n"
+      << "const size_t PREDICTION_LENGTH = " << prediction_length << ";\n";
+
+  std::vector<bool> has_leaf_values(trees.size());
+  for (size_t tree_index = 0; tree_index < trees.size(); ++tree_index) {
+    const PredictionValues& prediction_values = trees[tree_index]->get_prediction_values();
+    if (prediction_values.get_num_nodes() == 0) {
+      throw std::runtime_error("Only forests trained with an optimized prediction strategy can be compiled.");
+    }
+    if (prediction_values.get_num_types() != num_types && prediction_values.get_num_types() != 0) {
+      throw std::runtime_error("The forest's prediction values do not match the compiled prediction strategy.");
+    }
+    for (size_t node = 0; node < prediction_values.get_num_nodes(); ++node) {
+      has_leaf_values[tree_index] = has_leaf_values[tree_index] || !prediction_values.empty(node);
+    }
+    compile_tree(*trees[tree_index], tree_index, out);
+  }
+
+  out << "\n"
+      << "} // namespace\n"
+      << "\n"
+      << "extern \"C\" size_t grf_prediction_length() {\n"
+      << "  return PREDICTION_LENGTH;\n"
+      << "}\n"
+      << "\n"
+      << "extern \"C\" void grf_predict(const double* x, double* prediction) {\n"
+      << "  double average[NUM_TYPES] = {};\n"
+      << "  size_t num_leaves = 0;\n"
+      << "  int leaf;\n";
+
+  // Trees are added in order, as in OptimizedPredictionCollector.
+  for (size_t tree_index = 0; tree_index < trees.size(); ++tree_index) {
+    if (!has_leaf_values[tree_index]) {
+      continue;
+    }
+    out << "  leaf = tree_" << tree_index << "(x);\n"
+        << "  if (leaf >= 0) {\n"
+        << "    num_leaves++;\n"
+        << "    for (size_t type = 0; type < NUM_TYPES; ++type) {\n"
+        << "      average[type] += tree_" << tree_index << "_values[leaf][type];\n"
+        << "    }\n"
+        << "  }\n";
+  }
+
+  out << "  if (num_leaves == 0) {\n"
+      << "    for (size_t i = 0; i < PREDICTION_LENGTH; ++i) {\n"
+      << "      prediction[i] = NAN;\n"
+      << "    }\n"
+      << "    return;\n"
+      << "  }\n"
+      << "  for (size_t type = 0; type < NUM_TYPES; ++type) {\n"
+      << "    average[type] /= num_leaves;\n"
+      << "  }\n"
+      << prediction_code
+      << "}\n";
+}
+
+std::string ForestCompiler::average_value(size_t type) {
+  return "average[" + std::to_string(type) + "]";
+}
+
+void ForestCompiler::compile_tree(const Tree& tree,
+                                  size_t tree_index,
+                                  std::ostream& out) const {
+  const PredictionValues& prediction_values = tree.get_prediction_values();
+
+  // The non-empty leaves are numbered in the order they are laid out in the table.
+  std::vector<int> leaf_index_by_node(tree.get_num_nodes(), -1);
+  std::vector<size_t> leaves;
+  for (size_t node = 0; node < prediction_values.get_num_nodes(); ++node) {
+    if (!prediction_values.empty(node)) {
+      leaf_index_by_node[node] = static_cast<int>(leaves.size());
+      leaves.push_back(node);
+    }
+  }
+
+  out << "\n";
+  if (!leaves.empty()) {
+    out << "const double tree_" << tree_index << "_values[][NUM_TYPES] = {\n";
+    for (size_t node : leaves) {
+      out << "  {";
+      for (size_t type = 0; type < num_types; ++type) {
+        out << (type > 0 ? ", " : "") << format_double(prediction_values.get(node, type));
+      }
+      out << "},\n";
+    }
+    out << "};\n\n";
+  }
+
+  out << "int tree_" << tree_index << "(const double* x) {\n";
+  compile_node(tree, tree.get_root_node(), leaf_index_by_node, 1, out);
+  out << "}\n";
+}
+
+void ForestCompiler::compile_node(const Tree& tree,
+                                  size_t node,
+                                  const std::vector<int>& leaf_index_by_node,
+                                  size_t depth,
+                                  std::ostream& out) const {
+  std::string indent(2 * depth, ' ');
+  if (tree.is_leaf(node)) {
+    out << indent << "return " << leaf_index_by_node[node] << ";\n";
+    return;
+  }
+
+  // Reproduces Tree::descend, specialized to this node's split value and NaN direction.
+  std::string value = "x[" + std::to_string(tree.get_split_var(node)) + "]";
+  double split_value = tree.get_split_value(node);
+  out << indent << "if (";
+  if (std::isnan(split_value)) {
+    out << "std::isnan(" << value << ")";
+  } else if (tree.get_send_missing_left(node)) {
+    out << value << " <= " << format_double(split_value) << " || std::isnan(" << value << ")";
+  } else {
+    out << value << " <= " << format_double(split_value);
+  }
+  out << ") {\n";
+  compile_node(tree, tree.get_left_child(node), leaf_index_by_node, depth + 1, out);
+  out << indent << "} else {\n";
+  compile_node(tree, tree.get_right_child(node), leaf_index_by_node, depth + 1, out);
+  out << indent << "}\n";
+}
+
+std::string ForestCompiler::format_double(double value) {
+  if (std::isnan(value)) {
+    return "NAN";
+  } else if (std::isinf(value)) {
+    return value > 0 ? "INFINITY" : "-INFINITY";
+  }
+
+  // Seventeen significant digits are enough for the literal to round-trip exactly.
+  std::ostringstream stream;
+  stream.precision(17);
+  stream << value;
+  std::string literal = stream.str();
+  if (literal.find_first_of(".e") == std::string::npos) {
+    literal += ".0";
+  }
+  return literal;
+}
+
+} // namespace grf
@@ -0,0 +1,89 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_FORESTCOMPILER_H
+#define GRF_FORESTCOMPILER_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "forest/Forest.h"
+
+namespace grf {
+
+/**
+ * Compiles a trained forest ahead of time into a self-contained C++ translation unit,
+ * for serving fixed forests without the generic prediction machinery.
+ *
+ * Every tree becomes a function of nested if/else statements with its split values
+ * inlined, returning an index into a constant table of its leaves' prediction values
+ * (or -1 for an empty leaf). The unit exports two C functions:
+ *
+ *   size_t grf_prediction_length();
+ *   void grf_predict(const double* x, double* prediction);
+ *
+ * where x holds one value per column of the training data, and prediction receives
+ * grf_prediction_length() values. Leaf values are averaged and combined exactly as
+ * in OptimizedPredictionCollector, so that as long as the unit is compiled without
+ * floating point contraction or fast-math (for example with -O2 -ffp-contract=off),
+ * its predictions are bit-for-bit identical to those of ForestPredictor.
+ *
+ * Only forests trained with an optimized prediction strategy can be compiled. Please
+ * see ForestCompilers.h for compilers of the supported strategies.
+ */
+class ForestCompiler {
+public:
+  /**
+   * @param num_types The number of prediction values stored in each leaf.
+   * @param prediction_length The number of values in each prediction.
+   * @param prediction_code C++ statements that fill in prediction[] from the
+   * averaged prediction values in average[], as the strategy's predict would.
+   */
+  ForestCompiler(size_t num_types,
+                 size_t prediction_length,
+                 const std::string& prediction_code);
+
+  void compile(const Forest& forest, std::ostream& out) const;
+
+  /**
+   * The C++ expression for the averaged prediction value of the given type,
+   * for use in prediction code.
+   */
+  static std::string average_value(size_t type);
+
+private:
+  void compile_tree(const Tree& tree,
+                    size_t tree_index,
+                    std::ostream& out) const;
+
+  void compile_node(const Tree& tree,
+                    size_t node,
+                    const std::vector<int>& leaf_index_by_node,
+                    size_t depth,
+                    std::ostream& out) const;
+
+  static std::string format_double(double value);
+
+  size_t num_types;
+  size_t prediction_length;
+  std::string prediction_code;
+};
+
+} // namespace grf
+
+#endif //GRF_FORESTCOMPILER_H
@@ -0,0 +1,65 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <string>
+
+#include "forest/ForestCompilers.h"
+#include "prediction/InstrumentalPredictionStrategy.h"
+#include "prediction/RegressionPredictionStrategy.h"
+
+namespace grf {
+
+// The prediction code of each compiler mirrors the predict method of its strategy,
+// operation for operation, so that compiled predictions are bit-for-bit identical.
+
+ForestCompiler instrumental_compiler() {
+  InstrumentalPredictionStrategy strategy;
+  std::string outcome = ForestCompiler::average_value(InstrumentalPredictionStrategy::OUTCOME);
+  std::string treatment = ForestCompiler::average_value(InstrumentalPredictionStrategy::TREATMENT);
+  std::string instrument = ForestCompiler::average_value(InstrumentalPredictionStrategy::INSTRUMENT);
+  std::string outcome_instrument = ForestCompiler::average_value(InstrumentalPredictionStrategy::OUTCOME_INSTRUMENT);
+  std::string treatment_instrument = ForestCompiler::average_value(InstrumentalPredictionStrategy::TREATMENT_INSTRUMENT);
+  std::string weight = ForestCompiler::average_value(InstrumentalPredictionStrategy::WEIGHT);
+
+  std::string code =
+      "  double instrument_effect_numerator = " + outcome_instrument + " * " + weight
+          + " - " + outcome + " * " + instrument + ";\n"
+      "  double first_stage_numerator = " + treatment_instrument + " * " + weight
+          + " - " + treatment + " * " + instrument + ";\n"
+      "  prediction[0] = instrument_effect_numerator / first_stage_numerator;\n";
+  return ForestCompiler(strategy.prediction_value_length(), strategy.prediction_length(), code);
+}
+
+ForestCompiler probability_compiler(size_t num_classes) {
+  std::string code =
+      "  double weight_bar = " + ForestCompiler::average_value(num_classes) + ";\n"
+      "  for (size_t cls = 0; cls < " + std::to_string(num_classes) + "; ++cls) {\n"
+      "    prediction[cls] = average[cls] / weight_bar;\n"
+      "  }\n";
+  return ForestCompiler(num_classes + 1, num_classes, code);
+}
+
+ForestCompiler regression_compiler() {
+  RegressionPredictionStrategy strategy;
+  std::string outcome = ForestCompiler::average_value(RegressionPredictionStrategy::OUTCOME);
+  std::string weight = ForestCompiler::average_value(RegressionPredictionStrategy::WEIGHT);
+
+  std::string code = "  prediction[0] = " + outcome + " / " + weight + ";\n";
+  return ForestCompiler(strategy.prediction_value_length(), strategy.prediction_length(), code);
+}
+
+} // namespace grf
@@ -38,9 +38,29 @@ ForestOptions::ForestOptions(uint num_trees,
                              uint random_seed,
                              const std::vector<size_t>& sample_clusters,
                              uint samples_per_cluster):
+    ForestOptions(num_trees, ci_group_size, sample_fraction, mtry, min_node_size, honesty,
+                  honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads,
+                  random_seed, sample_clusters, samples_per_cluster, true) {}
+
+ForestOptions::ForestOptions(uint num_trees,
+                             size_t ci_group_size,
+                             double sample_fraction,
+                             uint mtry,
+                             uint min_node_size,
+                             bool honesty,
+                             double honesty_fraction,
+                             bool honesty_prune_leaves,
+                             double alpha,
+                             double imbalance_penalty,
+                             uint num_threads,
+                             uint random_seed,
+                             const std::vector<size_t>& sample_clusters,
+                             uint samples_per_cluster,
+                             bool keep_leaf_samples):
     ci_group_size(ci_group_size),
     sample_fraction(sample_fraction),
-    tree_options(mtry, min_node_size, honesty, honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty),
+    tree_options(mtry, min_node_size, honesty, honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty,
+                 keep_leaf_samples),
     sampling_options(samples_per_cluster, sample_clusters) {
 
   this->num_threads = validate_num_threads(num_threads);
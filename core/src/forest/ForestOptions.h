@@ -42,6 +42,28 @@ public:
                 const std::vector<size_t>& sample_clusters,
                 uint samples_per_cluster);
 
+  /**
+   * As above, but if keep_leaf_samples is false trees only keep their precomputed
+   * prediction values, which greatly reduces the size of the forest. This requires
+   * an optimized prediction strategy, and the resulting forest cannot be used for
+   * predictions or analyses that need sample weights.
+   */
+  ForestOptions(uint num_trees,
+                size_t ci_group_size,
+                double sample_fraction,
+                uint mtry,
+                uint min_node_size,
+                bool honesty,
+                double honesty_fraction,
+                bool honesty_prune_leaves,
+                double alpha,
+                double imbalance_penalty,
+                uint num_threads,
+                uint random_seed,
+                const std::vector<size_t>& sample_clusters,
+                uint samples_per_cluster,
+                bool keep_leaf_samples);
+
   static uint validate_num_threads(uint num_threads);
 
   uint get_num_trees() const;
@@ -26,18 +26,31 @@ namespace grf {
 
 ForestPredictor::ForestPredictor(uint num_threads,
                                  std::unique_ptr<DefaultPredictionStrategy> strategy) :
-    tree_traverser(num_threads) {
-  this->prediction_collector = std::unique_ptr<PredictionCollector>(
-        new DefaultPredictionCollector(std::move(strategy), num_threads));
+    tree_traverser(num_threads),
+    optimized_collector(nullptr) {
+  DefaultPredictionCollector* collector = new DefaultPredictionCollector(std::move(strategy), num_threads);
+  this->default_collector = collector;
+  this->prediction_collector = std::unique_ptr<PredictionCollector>(collector);
 }
 
 ForestPredictor::ForestPredictor(uint num_threads,
                                  std::unique_ptr<OptimizedPredictionStrategy> strategy) :
-    tree_traverser(num_threads) {
-  this->prediction_collector = std::unique_ptr<PredictionCollector>(
-      new OptimizedPredictionCollector(std::move(strategy), num_threads));
+    tree_traverser(num_threads),
+    default_collector(nullptr) {
+  OptimizedPredictionCollector* collector = new OptimizedPredictionCollector(std::move(strategy), num_threads);
+  this->optimized_collector = collector;
+  this->prediction_collector = std::unique_ptr<PredictionCollector>(collector);
 }
 
+ForestPredictor::ForestPredictor(uint num_threads,
+                                 std::unique_ptr<PredictionCollector> collector,
+                                 std::unique_ptr<DefaultPredictionStrategy> kernel_strategy) :
+    tree_traverser(num_threads),
+    prediction_collector(std::move(collector)),
+    optimized_collector(nullptr),
+    kernel_collector(new DefaultPredictionCollector(std::move(kernel_strategy), num_threads)) {
+  this->default_collector = kernel_collector.get();
+}
 
 std::vector<Prediction> ForestPredictor::predict(const Forest& forest,
                                                  const Data& train_data,
@@ -52,6 +65,15 @@ std::vector<Prediction> ForestPredictor::predict_oob(const Forest& forest,
   return predict(forest, data, data, estimate_variance, true);
 }
 
+std::vector<Prediction> ForestPredictor::predict_with_kernel(const ForestWeights& kernel,
+                                                             const Data& train_data,
+                                                             const Data& data) const {
+  if (default_collector == nullptr) {
+    throw std::runtime_error("Predicting from a forest kernel requires a default prediction strategy.");
+  }
+  return default_collector->collect_predictions(kernel, train_data, data);
+}
+
 std::vector<Prediction> ForestPredictor::predict(const Forest& forest,
                                                  const Data& train_data,
                                                  const Data& data,
@@ -62,12 +84,34 @@ std::vector<Prediction> ForestPredictor::predict(const Forest& forest,
        " be trained with ci_group_size greater than 1.");
   }
 
-  std::vector<std::vector<size_t>> leaf_nodes_by_tree = tree_traverser.get_leaf_nodes(forest, data, oob_prediction);
-  std::vector<std::vector<bool>> trees_by_sample = tree_traverser.get_valid_trees_by_sample(forest, data, oob_prediction);
+  // Optimized predictions avoid materializing the leaf nodes for all samples and trees,
+  // unless OOB prediction must regenerate drawn samples that the trees no longer store.
+  bool has_drawn_samples = forest.get_drawn_sample_regenerator() == nullptr;
+  if (optimized_collector != nullptr && (!oob_prediction || has_drawn_samples)) {
+    return optimized_collector->collect_predictions(forest, data, estimate_variance, oob_prediction);
+  }
+
+  LeafAssignments leaf_assignments = tree_traverser.get_leaf_assignments(forest, data, oob_prediction);
+  return prediction_collector->collect_predictions(forest, train_data, data,
+      leaf_assignments, estimate_variance, oob_prediction);
+}
+
+std::vector<Prediction> ForestPredictor::predict(const Forest& forest,
+                                                 const Data& train_data,
+                                                 const Data& data,
+                                                 const LeafAssignments& leaf_assignments,
+                                                 bool estimate_variance) const {
+  if (estimate_variance && forest.get_ci_group_size() <= 1) {
+    throw std::runtime_error("To estimate variance during prediction, the forest must"
+       " be trained with ci_group_size greater than 1.");
+  }
+  if (leaf_assignments.get_num_trees() != forest.get_trees().size() ||
+      leaf_assignments.get_num_samples() != data.get_num_rows()) {
+    throw std::runtime_error("The leaf assignments were not computed for this forest and data.");
+  }
 
   return prediction_collector->collect_predictions(forest, train_data, data,
-      leaf_nodes_by_tree, trees_by_sample,
-      estimate_variance, oob_prediction);
+      leaf_assignments, estimate_variance, leaf_assignments.is_oob_prediction());
 }
 
 } // namespace grf
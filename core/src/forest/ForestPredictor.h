@@ -18,11 +18,14 @@
 #ifndef GRF_FORESTPREDICTOR_H
 #define GRF_FORESTPREDICTOR_H
 
+#include "analysis/ForestWeights.h"
 #include "relabeling/RelabelingStrategy.h"
 #include "splitting/SplittingRule.h"
 #include "prediction/Prediction.h"
 #include "prediction/collector/TreeTraverser.h"
 #include "prediction/collector/PredictionCollector.h"
+#include "prediction/collector/OptimizedPredictionCollector.h"
+#include "prediction/collector/DefaultPredictionCollector.h"
 #include "prediction/collector/SampleWeightComputer.h"
 #include "prediction/OptimizedPredictionStrategy.h"
 #include "prediction/DefaultPredictionStrategy.h"
@@ -45,6 +48,15 @@ public:
   ForestPredictor(uint num_threads,
                   std::unique_ptr<OptimizedPredictionStrategy> strategy);
 
+  /**
+   * Predicts through a specialized collector, such as QuantilePredictionCollector. As
+   * forest kernels carry no leaf information, predictions from a kernel instead use the
+   * given default strategy, which should compute the same predictions from sample weights.
+   */
+  ForestPredictor(uint num_threads,
+                  std::unique_ptr<PredictionCollector> collector,
+                  std::unique_ptr<DefaultPredictionStrategy> kernel_strategy);
+
   std::vector<Prediction> predict(const Forest& forest,
                                   const Data& train_data,
                                   const Data& data,
@@ -54,6 +66,31 @@ public:
                                       const Data& data,
                                       bool estimate_variance) const;
 
+  /**
+   * Predict from leaf assignments computed beforehand by TreeTraverser::get_leaf_assignments,
+   * so that several predictions for the same forest and data (point estimates, variance,
+   * or different strategies) share a single traversal. The predictions are OOB if the
+   * leaf assignments are, in which case train_data and data should both be the training data.
+   */
+  std::vector<Prediction> predict(const Forest& forest,
+                                  const Data& train_data,
+                                  const Data& data,
+                                  const LeafAssignments& leaf_assignments,
+                                  bool estimate_variance) const;
+
+  /**
+   * Predict from a precomputed forest kernel, as returned by ForestWeightsComputer, rather
+   * than by traversing the forest. Computing the kernel once lets many predictions on the
+   * same forest and data, such as several quantile sets or local linear lambdas, share a
+   * single traversal. Only point predictions are returned.
+   *
+   * This requires a DefaultPredictionStrategy, since optimized strategies do not predict
+   * from sample weights.
+   */
+  std::vector<Prediction> predict_with_kernel(const ForestWeights& kernel,
+                                              const Data& train_data,
+                                              const Data& data) const;
+
 private:
   std::vector<Prediction> predict(const Forest& forest,
                                   const Data& train_data,
@@ -64,6 +101,15 @@ private:
 private:
   TreeTraverser tree_traverser;
   std::unique_ptr<PredictionCollector> prediction_collector;
+
+  // The prediction collector, if it supports fused optimized prediction (not owned).
+  const OptimizedPredictionCollector* optimized_collector;
+
+  // The collector used for predictions from sample weights, if the strategy supports them (not owned).
+  const DefaultPredictionCollector* default_collector;
+
+  // The collector for predictions from sample weights, if it is not the main prediction collector.
+  std::unique_ptr<DefaultPredictionCollector> kernel_collector;
 };
 
 } // namespace grf
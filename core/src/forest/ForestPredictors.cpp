@@ -26,6 +26,10 @@
 #include "prediction/LLCausalPredictionStrategy.h"
 #include "prediction/SurvivalPredictionStrategy.h"
 #include "prediction/CausalSurvivalPredictionStrategy.h"
+#include "prediction/collector/LLCausalPredictionCollector.h"
+#include "prediction/collector/LocalLinearPredictionCollector.h"
+#include "prediction/collector/QuantilePredictionCollector.h"
+#include "prediction/collector/SurvivalPredictionCollector.h"
 
 namespace grf {
 
@@ -44,8 +48,9 @@ ForestPredictor multi_causal_predictor(uint num_threads, size_t num_treatments,
 ForestPredictor quantile_predictor(uint num_threads,
                                    const std::vector<double>& quantiles) {
   num_threads = ForestOptions::validate_num_threads(num_threads);
-  std::unique_ptr<DefaultPredictionStrategy> prediction_strategy(new QuantilePredictionStrategy(quantiles));
-  return ForestPredictor(num_threads, std::move(prediction_strategy));
+  std::unique_ptr<PredictionCollector> prediction_collector(new QuantilePredictionCollector(quantiles, num_threads));
+  std::unique_ptr<DefaultPredictionStrategy> kernel_strategy(new QuantilePredictionStrategy(quantiles));
+  return ForestPredictor(num_threads, std::move(prediction_collector), std::move(kernel_strategy));
 }
 
 ForestPredictor probability_predictor(uint num_threads, size_t num_classes) {
@@ -71,9 +76,11 @@ ForestPredictor ll_regression_predictor(uint num_threads,
                                         bool weight_penalty,
                                         std::vector<size_t> linear_correction_variables) {
   num_threads = ForestOptions::validate_num_threads(num_threads);
-  std::unique_ptr<DefaultPredictionStrategy> prediction_strategy(
+  std::unique_ptr<PredictionCollector> prediction_collector(
+      new LocalLinearPredictionCollector(lambdas, weight_penalty, linear_correction_variables, num_threads));
+  std::unique_ptr<DefaultPredictionStrategy> kernel_strategy(
       new LocalLinearPredictionStrategy(lambdas, weight_penalty, linear_correction_variables));
-  return ForestPredictor(num_threads, std::move(prediction_strategy));
+  return ForestPredictor(num_threads, std::move(prediction_collector), std::move(kernel_strategy));
 }
 
 ForestPredictor ll_causal_predictor(uint num_threads,
@@ -81,16 +88,20 @@ ForestPredictor ll_causal_predictor(uint num_threads,
                                     bool weight_penalty,
                                     std::vector<size_t> linear_correction_variables) {
   num_threads = ForestOptions::validate_num_threads(num_threads);
-  std::unique_ptr<DefaultPredictionStrategy> prediction_strategy(
-          new LLCausalPredictionStrategy(lambdas, weight_penalty, linear_correction_variables));
-  return ForestPredictor(num_threads, std::move(prediction_strategy));
+  std::unique_ptr<PredictionCollector> prediction_collector(
+      new LLCausalPredictionCollector(lambdas, weight_penalty, linear_correction_variables, num_threads));
+  std::unique_ptr<DefaultPredictionStrategy> kernel_strategy(
+      new LLCausalPredictionStrategy(lambdas, weight_penalty, linear_correction_variables));
+  return ForestPredictor(num_threads, std::move(prediction_collector), std::move(kernel_strategy));
 }
 
 ForestPredictor survival_predictor(uint num_threads, size_t num_failures, int prediction_type) {
   num_threads = ForestOptions::validate_num_threads(num_threads);
-  std::unique_ptr<DefaultPredictionStrategy> prediction_strategy(
+  std::unique_ptr<PredictionCollector> prediction_collector(
+    new SurvivalPredictionCollector(num_failures, prediction_type, num_threads));
+  std::unique_ptr<DefaultPredictionStrategy> kernel_strategy(
     new SurvivalPredictionStrategy(num_failures, prediction_type));
-  return ForestPredictor(num_threads, std::move(prediction_strategy));
+  return ForestPredictor(num_threads, std::move(prediction_collector), std::move(kernel_strategy));
 }
 
 ForestPredictor causal_survival_predictor(uint num_threads) {
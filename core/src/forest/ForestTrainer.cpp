@@ -22,7 +22,7 @@
 
 #include "commons/utility.h"
 #include "ForestTrainer.h"
-#include "random/random.hpp"
+#include "forest/OOBConvergenceTracker.h"
 
 
 namespace grf {
@@ -35,7 +35,63 @@ ForestTrainer::ForestTrainer(std::unique_ptr<RelabelingStrategy> relabeling_stra
                  std::move(prediction_strategy)) {}
 
 Forest ForestTrainer::train(const Data& data, const ForestOptions& options) const {
-  std::vector<std::unique_ptr<Tree>> trees = train_trees(data, options);
+  TrainingBudget unlimited_budget;
+  size_t num_groups = options.get_num_trees() / options.get_ci_group_size();
+  std::vector<std::unique_ptr<Tree>> trees = train_trees(data, options, 0, num_groups, unlimited_budget);
+
+  size_t num_variables = data.get_num_cols() - data.get_disallowed_split_variables().size();
+  size_t ci_group_size = options.get_ci_group_size();
+  return Forest(trees, num_variables, ci_group_size);
+}
+
+Forest ForestTrainer::train(const Data& data,
+                            const ForestOptions& options,
+                            size_t increment_size,
+                            double tolerance,
+                            OOBConvergence& convergence) const {
+  const OptimizedPredictionStrategy* prediction_strategy = tree_trainer.get_prediction_strategy();
+  if (prediction_strategy == nullptr) {
+    throw std::runtime_error("Early stopping requires a forest with an optimized prediction strategy.");
+  }
+  if (increment_size == 0) {
+    throw std::runtime_error("The early stopping increment must contain at least one tree group.");
+  }
+
+  TrainingBudget unlimited_budget;
+  size_t num_groups = options.get_num_trees() / options.get_ci_group_size();
+  OOBConvergenceTracker tracker(*prediction_strategy, data, options.get_num_threads());
+
+  std::vector<std::unique_ptr<Tree>> trees;
+  trees.reserve(options.get_num_trees());
+  bool converged = false;
+
+  for (size_t start_group = 0; start_group < num_groups && !converged; start_group += increment_size) {
+    size_t num_groups_increment = std::min(increment_size, num_groups - start_group);
+    std::vector<std::unique_ptr<Tree>> increment_trees = train_trees(data, options, start_group, num_groups_increment,
+                                                                       unlimited_budget);
+
+    tracker.add_trees(increment_trees);
+    converged = tracker.has_converged(tolerance);
+
+    trees.insert(trees.end(),
+                 std::make_move_iterator(increment_trees.begin()),
+                 std::make_move_iterator(increment_trees.end()));
+  }
+  convergence = tracker.get_convergence(converged);
+
+  size_t num_variables = data.get_num_cols() - data.get_disallowed_split_variables().size();
+  size_t ci_group_size = options.get_ci_group_size();
+  return Forest(trees, num_variables, ci_group_size);
+}
+
+Forest ForestTrainer::train(const Data& data,
+                            const ForestOptions& options,
+                            TrainingBudget& budget) const {
+  size_t num_groups = options.get_num_trees() / options.get_ci_group_size();
+  std::vector<std::unique_ptr<Tree>> trees = train_trees(data, options, 0, num_groups, budget);
+  if (trees.empty()) {
+    throw std::runtime_error("The training budget was exhausted before a single tree group was grown.");
+  }
 
   size_t num_variables = data.get_num_cols() - data.get_disallowed_split_variables().size();
   size_t ci_group_size = options.get_ci_group_size();
@@ -43,9 +99,11 @@ Forest ForestTrainer::train(const Data& data, const ForestOptions& options) cons
 }
 
 std::vector<std::unique_ptr<Tree>> ForestTrainer::train_trees(const Data& data,
-                                                              const ForestOptions& options) const {
+                                                              const ForestOptions& options,
+                                                              size_t start_group,
+                                                              size_t num_groups,
+                                                              TrainingBudget& budget) const {
   size_t num_samples = data.get_num_rows();
-  uint num_trees = options.get_num_trees();
 
   // Ensure that the sample fraction is not too small and honesty fraction is not too extreme.
   const TreeOptions& tree_options = options.get_tree_options();
@@ -58,16 +116,21 @@ std::vector<std::unique_ptr<Tree>> ForestTrainer::train_trees(const Data& data,
     throw std::runtime_error("The honesty fraction is too close to 1 or 0, as no observations will be sampled.");
   }
 
-  uint num_groups = static_cast<uint>(num_trees / options.get_ci_group_size());
+  if (!tree_options.get_keep_leaf_samples() && tree_trainer.get_prediction_strategy() == nullptr) {
+    throw std::runtime_error("Leaf samples can only be discarded for forests with an optimized prediction strategy.");
+  }
 
   std::vector<uint> thread_ranges;
-  split_sequence(thread_ranges, 0, num_groups - 1, options.get_num_threads());
+  split_sequence(thread_ranges,
+                 static_cast<uint>(start_group),
+                 static_cast<uint>(start_group + num_groups - 1),
+                 options.get_num_threads());
 
   std::vector<std::future<std::vector<std::unique_ptr<Tree>>>> futures;
   futures.reserve(thread_ranges.size());
 
   std::vector<std::unique_ptr<Tree>> trees;
-  trees.reserve(num_trees);
+  trees.reserve(num_groups * options.get_ci_group_size());
 
   for (uint i = 0; i < thread_ranges.size() - 1; ++i) {
     size_t start_index = thread_ranges[i];
@@ -79,7 +142,8 @@ std::vector<std::unique_ptr<Tree>> ForestTrainer::train_trees(const Data& data,
                                  start_index,
                                  num_trees_batch,
                                  std::ref(data),
-                                 options));
+                                 options,
+                                 std::ref(budget)));
   }
 
   for (auto& future : futures) {
@@ -96,52 +160,79 @@ std::vector<std::unique_ptr<Tree>> ForestTrainer::train_batch(
     size_t start,
     size_t num_trees,
     const Data& data,
-    const ForestOptions& options) const {
+    const ForestOptions& options,
+    TrainingBudget& budget) const {
   size_t ci_group_size = options.get_ci_group_size();
 
-  std::mt19937_64 random_number_generator(options.get_random_seed() + start);
-  nonstd::uniform_int_distribution<uint> udist;
   std::vector<std::unique_ptr<Tree>> trees;
   trees.reserve(num_trees * ci_group_size);
 
-  for (size_t i = 0; i < num_trees; i++) {
-    uint tree_seed = udist(random_number_generator);
+  for (size_t i = 0; i < num_trees && !budget.is_exhausted(); i++) {
+    // Each group's seed is a function of its global index only, so the forest
+    // does not depend on how the groups are split across threads.
+    uint tree_seed = RandomSampler::get_group_seed(options.get_random_seed(), start + i);
     RandomSampler sampler(tree_seed, options.get_sampling_options());
 
+    std::vector<std::unique_ptr<Tree>> group;
     if (ci_group_size == 1) {
-      std::unique_ptr<Tree> tree = train_tree(data, sampler, options);
-      trees.push_back(std::move(tree));
+      std::unique_ptr<Tree> tree = train_tree(data, sampler, options, budget);
+      if (tree != nullptr) {
+        group.push_back(std::move(tree));
+      }
     } else {
-      std::vector<std::unique_ptr<Tree>> group = train_ci_group(data, sampler, options);
-      trees.insert(trees.end(),
-          std::make_move_iterator(group.begin()),
-          std::make_move_iterator(group.end()));
+      group = train_ci_group(data, sampler, options, budget);
+    }
+    for (size_t j = 0; j < group.size(); ++j) {
+      group[j]->set_drawn_samples_seed(tree_seed, j);
+    }
+
+    // A group that was interrupted, or that does not fit in the remaining
+    // memory, is discarded so the forest only contains complete groups.
+    if (group.empty()) {
+      break;
     }
+    size_t group_memory = 0;
+    for (const auto& tree : group) {
+      group_memory += tree->estimate_memory_usage();
+    }
+    if (!budget.reserve_memory(group_memory)) {
+      break;
+    }
+
+    trees.insert(trees.end(),
+        std::make_move_iterator(group.begin()),
+        std::make_move_iterator(group.end()));
   }
   return trees;
 }
+
 std::unique_ptr<Tree> ForestTrainer::train_tree(const Data& data,
                                                 RandomSampler& sampler,
-                                                const ForestOptions& options) const {
-  std::vector<size_t> clusters;
-  sampler.sample_clusters(data.get_num_rows(), options.get_sample_fraction(), clusters);
-  return tree_trainer.train(data, sampler, clusters, options.get_tree_options());
+                                                const ForestOptions& options,
+                                                const TrainingBudget& budget) const {
+  std::vector<std::vector<size_t>> clusters = DrawnSampleRegenerator::draw_group_clusters(
+      sampler, data.get_num_rows(), options.get_sample_fraction(), 1, 1);
+  return tree_trainer.train(data, sampler, clusters[0], options.get_tree_options(), budget);
 }
 
 std::vector<std::unique_ptr<Tree>> ForestTrainer::train_ci_group(const Data& data,
                                                                  RandomSampler& sampler,
-                                                                 const ForestOptions& options) const {
+                                                                 const ForestOptions& options,
+                                                                 const TrainingBudget& budget) const {
   std::vector<std::unique_ptr<Tree>> trees;
 
-  std::vector<size_t> clusters;
-  sampler.sample_clusters(data.get_num_rows(), 0.5, clusters);
-
-  double sample_fraction = options.get_sample_fraction();
-  for (size_t i = 0; i < options.get_ci_group_size(); ++i) {
-    std::vector<size_t> cluster_subsample;
-    sampler.subsample(clusters, sample_fraction * 2, cluster_subsample);
-
-    std::unique_ptr<Tree> tree = tree_trainer.train(data, sampler, cluster_subsample, options.get_tree_options());
+  // All of the group's subsamples are drawn before any tree is grown, so that they
+  // only depend on the group's seed and can be regenerated after training.
+  size_t ci_group_size = options.get_ci_group_size();
+  std::vector<std::vector<size_t>> clusters_by_tree = DrawnSampleRegenerator::draw_group_clusters(
+      sampler, data.get_num_rows(), options.get_sample_fraction(), ci_group_size, ci_group_size);
+
+  for (const std::vector<size_t>& cluster_subsample : clusters_by_tree) {
+    std::unique_ptr<Tree> tree = tree_trainer.train(data, sampler, cluster_subsample,
+                                                    options.get_tree_options(), budget);
+    if (tree == nullptr) {
+      return {};
+    }
     trees.push_back(std::move(tree));
   }
   return trees;
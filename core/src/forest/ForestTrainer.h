@@ -27,6 +27,9 @@
 #include "tree/Tree.h"
 #include "tree/TreeTrainer.h"
 #include "forest/Forest.h"
+#include "forest/OOBConvergence.h"
+#include "forest/TrainingBudget.h"
+#include "sampling/DrawnSampleRegenerator.h"
 #include "ForestOptions.h"
 
 namespace grf {
@@ -39,24 +42,60 @@ public:
 
   Forest train(const Data& data, const ForestOptions& options) const;
 
+  /**
+   * Trains the forest in increments of tree groups, stopping early once the out-of-bag
+   * predictions have stabilized. The number of trees in options is treated as an upper bound.
+   *
+   * After each increment the OOB predictions are updated using only the new trees, and
+   * training stops once the relative squared change in OOB predictions caused by the
+   * increment falls below the tolerance. This requires an optimized prediction strategy.
+   *
+   * @param increment_size The number of tree groups (of ci_group_size trees each) per increment.
+   * @param tolerance The threshold on the relative change in OOB predictions.
+   * @param convergence Populated with the OOB convergence curve, with one entry per increment.
+   */
+  Forest train(const Data& data,
+               const ForestOptions& options,
+               size_t increment_size,
+               double tolerance,
+               OOBConvergence& convergence) const;
+
+  /**
+   * Trains as many complete tree groups as fit within the given wall-clock and memory
+   * budget, up to the number of trees in options. Once the budget runs out, training
+   * stops cleanly and the forest contains all tree groups completed so far.
+   *
+   * The number of trees actually grown can be read from the returned forest.
+   * Throws if the budget runs out before a single tree group is complete.
+   */
+  Forest train(const Data& data,
+               const ForestOptions& options,
+               TrainingBudget& budget) const;
+
 private:
 
   std::vector<std::unique_ptr<Tree>> train_trees(const Data& data,
-                                                 const ForestOptions& options) const;
+                                                 const ForestOptions& options,
+                                                 size_t start_group,
+                                                 size_t num_groups,
+                                                 TrainingBudget& budget) const;
 
   std::vector<std::unique_ptr<Tree>> train_batch(
       size_t start,
       size_t num_trees,
       const Data& data,
-      const ForestOptions& options) const;
+      const ForestOptions& options,
+      TrainingBudget& budget) const;
 
   std::unique_ptr<Tree> train_tree(const Data& data,
                                    RandomSampler& sampler,
-                                   const ForestOptions& options) const;
+                                   const ForestOptions& options,
+                                   const TrainingBudget& budget) const;
 
   std::vector<std::unique_ptr<Tree>> train_ci_group(const Data& data,
                                                     RandomSampler& sampler,
-                                                    const ForestOptions& options) const;
+                                                    const ForestOptions& options,
+                                                    const TrainingBudget& budget) const;
 
   TreeTrainer tree_trainer;
 };
@@ -0,0 +1,56 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include "forest/OOBConvergence.h"
+
+namespace grf {
+
+OOBConvergence::OOBConvergence():
+  has_converged(false) {}
+
+OOBConvergence::OOBConvergence(const std::vector<size_t>& num_trees,
+                               const std::vector<double>& oob_errors,
+                               const std::vector<double>& excess_errors,
+                               const std::vector<double>& prediction_changes,
+                               bool converged):
+  num_trees(num_trees),
+  oob_errors(oob_errors),
+  excess_errors(excess_errors),
+  prediction_changes(prediction_changes),
+  has_converged(converged) {}
+
+const std::vector<size_t>& OOBConvergence::get_num_trees() const {
+  return num_trees;
+}
+
+const std::vector<double>& OOBConvergence::get_oob_errors() const {
+  return oob_errors;
+}
+
+const std::vector<double>& OOBConvergence::get_excess_errors() const {
+  return excess_errors;
+}
+
+const std::vector<double>& OOBConvergence::get_prediction_changes() const {
+  return prediction_changes;
+}
+
+bool OOBConvergence::converged() const {
+  return has_converged;
+}
+
+} // namespace grf
@@ -0,0 +1,81 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_OOBCONVERGENCE_H
+#define GRF_OOBCONVERGENCE_H
+
+#include <cstddef>
+#include <vector>
+
+namespace grf {
+
+/**
+ * The convergence curve recorded when a forest is trained in increments with
+ * early stopping. There is one entry per increment of tree groups.
+ */
+class OOBConvergence {
+public:
+  OOBConvergence();
+
+  OOBConvergence(const std::vector<size_t>& num_trees,
+                 const std::vector<double>& oob_errors,
+                 const std::vector<double>& excess_errors,
+                 const std::vector<double>& prediction_changes,
+                 bool converged);
+
+  /**
+   * The number of trees in the forest after each increment.
+   */
+  const std::vector<size_t>& get_num_trees() const;
+
+  /**
+   * The out-of-bag debiased error after each increment, averaged over all training
+   * samples for which the prediction strategy provides an error estimate. This is NaN
+   * for strategies that do not implement error estimates.
+   */
+  const std::vector<double>& get_oob_errors() const;
+
+  /**
+   * The Monte Carlo ('excess') error of the out-of-bag predictions after each increment,
+   * averaged in the same way as get_oob_errors. This measures how much the predictions
+   * would still change if the forest were grown further.
+   */
+  const std::vector<double>& get_excess_errors() const;
+
+  /**
+   * The squared change in out-of-bag predictions caused by each increment, relative to the
+   * spread of the predictions across samples. The first entry is NaN.
+   */
+  const std::vector<double>& get_prediction_changes() const;
+
+  /**
+   * Whether training stopped because the predictions converged, as opposed to
+   * reaching the requested number of trees.
+   */
+  bool converged() const;
+
+private:
+  std::vector<size_t> num_trees;
+  std::vector<double> oob_errors;
+  std::vector<double> excess_errors;
+  std::vector<double> prediction_changes;
+  bool has_converged;
+};
+
+} // namespace grf
+
+#endif //GRF_OOBCONVERGENCE_H
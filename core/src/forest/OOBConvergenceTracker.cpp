@@ -0,0 +1,283 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+
+#include "commons/utility.h"
+#include "forest/OOBConvergenceTracker.h"
+
+namespace grf {
+
+const size_t OOBConvergenceTracker::NUM_ERROR_BLOCKS;
+
+OOBConvergenceTracker::OOBConvergenceTracker(const OptimizedPredictionStrategy& strategy,
+                                             const Data& data,
+                                             uint num_threads):
+    strategy(strategy),
+    data(data),
+    num_threads(num_threads),
+    num_trees(0),
+    num_increments(0) {
+  size_t num_samples = data.get_num_rows();
+  size_t num_types = strategy.prediction_value_length();
+  sums_by_sample.resize(num_samples, std::vector<double>(num_types));
+  num_leaves_by_sample.resize(num_samples);
+  block_sums.resize(num_samples * NUM_ERROR_BLOCKS * num_types);
+  block_num_leaves.resize(num_samples * NUM_ERROR_BLOCKS);
+  predictions_by_sample.resize(num_samples);
+
+  errors.resize(num_samples);
+  excess_errors.resize(num_samples);
+  squared_changes.resize(num_samples);
+  has_change.resize(num_samples);
+}
+
+void OOBConvergenceTracker::add_trees(const std::vector<std::unique_ptr<Tree>>& trees) {
+  size_t num_samples = data.get_num_rows();
+  size_t num_new_trees = trees.size();
+
+  std::vector<std::vector<bool>> oob_samples_by_tree(num_new_trees);
+  for (size_t i = 0; i < num_new_trees; ++i) {
+    std::vector<bool>& oob_samples = oob_samples_by_tree[i];
+    oob_samples.resize(num_samples, true);
+    for (size_t sample : trees[i]->get_drawn_samples()) {
+      oob_samples[sample] = false;
+    }
+  }
+
+  // Only the new trees are traversed, and each only over its own OOB samples.
+  std::vector<uint> tree_ranges;
+  split_sequence(tree_ranges, 0, static_cast<uint>(num_new_trees - 1), num_threads);
+
+  std::vector<std::future<std::vector<std::vector<size_t>>>> leaf_futures;
+  leaf_futures.reserve(tree_ranges.size());
+  for (uint i = 0; i < tree_ranges.size() - 1; ++i) {
+    size_t start_index = tree_ranges[i];
+    size_t num_trees_batch = tree_ranges[i + 1] - start_index;
+    leaf_futures.push_back(std::async(std::launch::async,
+                                      &OOBConvergenceTracker::find_leaf_nodes_batch,
+                                      this,
+                                      std::ref(trees),
+                                      std::ref(oob_samples_by_tree),
+                                      start_index,
+                                      num_trees_batch));
+  }
+
+  std::vector<std::vector<size_t>> leaf_nodes_by_tree;
+  leaf_nodes_by_tree.reserve(num_new_trees);
+  for (auto& future : leaf_futures) {
+    std::vector<std::vector<size_t>> leaf_nodes = future.get();
+    leaf_nodes_by_tree.insert(leaf_nodes_by_tree.end(),
+                              std::make_move_iterator(leaf_nodes.begin()),
+                              std::make_move_iterator(leaf_nodes.end()));
+  }
+
+  std::vector<uint> thread_ranges;
+  split_sequence(thread_ranges, 0, static_cast<uint>(num_samples - 1), num_threads);
+
+  std::vector<std::future<void>> futures;
+  futures.reserve(thread_ranges.size());
+  for (uint i = 0; i < thread_ranges.size() - 1; ++i) {
+    size_t start_index = thread_ranges[i];
+    size_t num_samples_batch = thread_ranges[i + 1] - start_index;
+    futures.push_back(std::async(std::launch::async,
+                                 &OOBConvergenceTracker::add_trees_batch,
+                                 this,
+                                 std::ref(trees),
+                                 std::ref(leaf_nodes_by_tree),
+                                 std::ref(oob_samples_by_tree),
+                                 start_index,
+                                 num_samples_batch));
+  }
+  for (auto& future : futures) {
+    future.get();
+  }
+  num_trees += num_new_trees;
+  num_increments++;
+
+  // Reduce the per-sample results into a point on the convergence curve.
+  double error_sum = 0;
+  double excess_error_sum = 0;
+  size_t num_errors = 0;
+  size_t num_excess_errors = 0;
+  for (size_t sample = 0; sample < num_samples; ++sample) {
+    if (!std::isnan(errors[sample])) {
+      error_sum += errors[sample];
+      num_errors++;
+    }
+    if (!std::isnan(excess_errors[sample])) {
+      excess_error_sum += excess_errors[sample];
+      num_excess_errors++;
+    }
+  }
+
+  // The squared change is measured relative to the spread of the predictions, so
+  // that the tolerance does not depend on the scale of the outcome.
+  size_t prediction_length = strategy.prediction_length();
+  std::vector<double> mean_prediction(prediction_length);
+  size_t num_changes = 0;
+  for (size_t sample = 0; sample < num_samples; ++sample) {
+    if (!has_change[sample]) {
+      continue;
+    }
+    for (size_t j = 0; j < prediction_length; ++j) {
+      mean_prediction[j] += predictions_by_sample[sample][j];
+    }
+    num_changes++;
+  }
+
+  double prediction_change = NAN;
+  if (num_changes > 0) {
+    double change_sum = 0;
+    double spread_sum = 0;
+    for (size_t sample = 0; sample < num_samples; ++sample) {
+      if (!has_change[sample]) {
+        continue;
+      }
+      change_sum += squared_changes[sample];
+      for (size_t j = 0; j < prediction_length; ++j) {
+        double deviation = predictions_by_sample[sample][j] - mean_prediction[j] / num_changes;
+        spread_sum += deviation * deviation;
+      }
+    }
+    if (spread_sum > 0) {
+      prediction_change = change_sum / spread_sum;
+    } else {
+      prediction_change = change_sum > 0 ? INFINITY : 0;
+    }
+  }
+
+  curve_num_trees.push_back(num_trees);
+  curve_oob_errors.push_back(num_errors > 0 ? error_sum / num_errors : NAN);
+  curve_excess_errors.push_back(num_excess_errors > 0 ? excess_error_sum / num_excess_errors : NAN);
+  curve_prediction_changes.push_back(prediction_change);
+}
+
+std::vector<std::vector<size_t>> OOBConvergenceTracker::find_leaf_nodes_batch(
+    const std::vector<std::unique_ptr<Tree>>& trees,
+    const std::vector<std::vector<bool>>& oob_samples_by_tree,
+    size_t start,
+    size_t num_trees) const {
+  std::vector<std::vector<size_t>> leaf_nodes_by_tree(num_trees);
+  for (size_t i = 0; i < num_trees; ++i) {
+    leaf_nodes_by_tree[i] = trees[start + i]->find_leaf_nodes(data, oob_samples_by_tree[start + i]);
+  }
+  return leaf_nodes_by_tree;
+}
+
+void OOBConvergenceTracker::add_trees_batch(const std::vector<std::unique_ptr<Tree>>& trees,
+                                            const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
+                                            const std::vector<std::vector<bool>>& oob_samples_by_tree,
+                                            size_t start,
+                                            size_t num_samples) {
+  size_t num_types = strategy.prediction_value_length();
+  size_t block = num_increments % NUM_ERROR_BLOCKS;
+  size_t num_blocks = std::min(num_increments + 1, NUM_ERROR_BLOCKS);
+  std::vector<std::vector<double>> block_values(num_blocks);
+
+  for (size_t sample = start; sample < start + num_samples; ++sample) {
+    std::vector<double> increment_sum(num_types);
+    size_t num_increment_leaves = 0;
+
+    for (size_t i = 0; i < trees.size(); ++i) {
+      if (!oob_samples_by_tree[i][sample]) {
+        continue;
+      }
+      size_t node = leaf_nodes_by_tree[i][sample];
+      const PredictionValues& prediction_values = trees[i]->get_prediction_values();
+      if (prediction_values.empty(node)) {
+        continue;
+      }
+      for (size_t type = 0; type < num_types; ++type) {
+        increment_sum[type] += prediction_values.get(node, type);
+      }
+      num_increment_leaves++;
+    }
+
+    std::vector<double>& sums = sums_by_sample[sample];
+    double* sample_block_sums = block_sums.data() + sample * NUM_ERROR_BLOCKS * num_types;
+    size_t* sample_block_num_leaves = block_num_leaves.data() + sample * NUM_ERROR_BLOCKS;
+    if (num_increment_leaves > 0) {
+      for (size_t type = 0; type < num_types; ++type) {
+        sums[type] += increment_sum[type];
+        sample_block_sums[block * num_types + type] += increment_sum[type];
+      }
+      num_leaves_by_sample[sample] += num_increment_leaves;
+      sample_block_num_leaves[block] += num_increment_leaves;
+    }
+
+    errors[sample] = NAN;
+    excess_errors[sample] = NAN;
+    has_change[sample] = false;
+    size_t num_leaves = num_leaves_by_sample[sample];
+    if (num_leaves == 0) {
+      continue;
+    }
+
+    std::vector<double> average(num_types);
+    for (size_t type = 0; type < num_types; ++type) {
+      average[type] = sums[type] / num_leaves;
+    }
+    std::vector<double> prediction = strategy.predict(average);
+
+    std::vector<double>& previous_prediction = predictions_by_sample[sample];
+    if (!previous_prediction.empty()) {
+      double squared_change = 0;
+      for (size_t j = 0; j < prediction.size(); ++j) {
+        double change = prediction[j] - previous_prediction[j];
+        squared_change += change * change;
+      }
+      squared_changes[sample] = squared_change;
+      has_change[sample] = !std::isnan(squared_change);
+    }
+    previous_prediction = prediction;
+
+    for (size_t b = 0; b < num_blocks; ++b) {
+      block_values[b].clear();
+      if (sample_block_num_leaves[b] > 0) {
+        for (size_t type = 0; type < num_types; ++type) {
+          block_values[b].push_back(sample_block_sums[b * num_types + type] / sample_block_num_leaves[b]);
+        }
+      }
+    }
+    PredictionValues block_prediction_values(block_values, num_types);
+    std::vector<std::pair<double, double>> error = strategy.compute_error(
+        sample, average, block_prediction_values, data);
+    errors[sample] = error[0].first;
+    excess_errors[sample] = error[0].second;
+  }
+}
+
+bool OOBConvergenceTracker::has_converged(double tolerance) const {
+  if (curve_prediction_changes.empty()) {
+    return false;
+  }
+  double prediction_change = curve_prediction_changes.back();
+  return !std::isnan(prediction_change) && prediction_change < tolerance;
+}
+
+OOBConvergence OOBConvergenceTracker::get_convergence(bool converged) const {
+  return OOBConvergence(curve_num_trees,
+                        curve_oob_errors,
+                        curve_excess_errors,
+                        curve_prediction_changes,
+                        converged);
+}
+
+} // namespace grf
@@ -0,0 +1,112 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_OOBCONVERGENCETRACKER_H
+#define GRF_OOBCONVERGENCETRACKER_H
+
+#include <memory>
+#include <vector>
+
+#include "commons/Data.h"
+#include "forest/OOBConvergence.h"
+#include "prediction/OptimizedPredictionStrategy.h"
+#include "tree/Tree.h"
+
+namespace grf {
+
+/**
+ * Tracks the out-of-bag predictions of a forest that is grown in increments.
+ *
+ * Rather than re-running OOB prediction over the whole forest after every increment,
+ * the tracker keeps running per-sample sums of the prediction values of all OOB leaves
+ * seen so far, and only traverses the trees added in the latest increment.
+ *
+ * To estimate the OOB error, the prediction values of each increment are summed into
+ * a 'block' per sample, and the averaged blocks are passed to the strategy's compute_error
+ * in place of the individual trees, so its jackknife over trees becomes a delete-a-block
+ * jackknife over increments. To keep memory bounded by the number of samples rather than
+ * the number of increments, there are at most NUM_ERROR_BLOCKS blocks, and increment k is
+ * folded into block k modulo NUM_ERROR_BLOCKS.
+ */
+class OOBConvergenceTracker {
+public:
+  OOBConvergenceTracker(const OptimizedPredictionStrategy& strategy,
+                        const Data& data,
+                        uint num_threads);
+
+  /**
+   * Updates the OOB accumulators with a new increment of trees, and records
+   * a new point on the convergence curve.
+   */
+  void add_trees(const std::vector<std::unique_ptr<Tree>>& trees);
+
+  /**
+   * Returns true if the relative change in OOB predictions caused by the
+   * latest increment is below the given tolerance.
+   */
+  bool has_converged(double tolerance) const;
+
+  OOBConvergence get_convergence(bool converged) const;
+
+  /**
+   * The maximum number of blocks of increments used for error estimates.
+   */
+  static const size_t NUM_ERROR_BLOCKS = 16;
+
+private:
+  std::vector<std::vector<size_t>> find_leaf_nodes_batch(const std::vector<std::unique_ptr<Tree>>& trees,
+                                                         const std::vector<std::vector<bool>>& oob_samples_by_tree,
+                                                         size_t start,
+                                                         size_t num_trees) const;
+
+  void add_trees_batch(const std::vector<std::unique_ptr<Tree>>& trees,
+                       const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
+                       const std::vector<std::vector<bool>>& oob_samples_by_tree,
+                       size_t start,
+                       size_t num_samples);
+
+  const OptimizedPredictionStrategy& strategy;
+  const Data& data;
+  uint num_threads;
+  size_t num_trees;
+  size_t num_increments;
+
+  // Running sums of prediction values over all OOB leaves, by sample.
+  std::vector<std::vector<double>> sums_by_sample;
+  std::vector<size_t> num_leaves_by_sample;
+  // Sums of prediction values by sample, then block, then type, and the number of
+  // non-empty OOB leaves in each sum, by sample, then block.
+  std::vector<double> block_sums;
+  std::vector<size_t> block_num_leaves;
+  std::vector<std::vector<double>> predictions_by_sample;
+
+  // Per-sample results for the latest increment. Flags are stored as chars rather than
+  // in a packed std::vector<bool>, since threads write to neighboring samples concurrently.
+  std::vector<double> errors;
+  std::vector<double> excess_errors;
+  std::vector<double> squared_changes;
+  std::vector<char> has_change;
+
+  std::vector<size_t> curve_num_trees;
+  std::vector<double> curve_oob_errors;
+  std::vector<double> curve_excess_errors;
+  std::vector<double> curve_prediction_changes;
+};
+
+} // namespace grf
+
+#endif //GRF_OOBCONVERGENCETRACKER_H
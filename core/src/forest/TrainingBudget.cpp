@@ -0,0 +1,75 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <stdexcept>
+
+#include "forest/TrainingBudget.h"
+
+namespace grf {
+
+TrainingBudget::TrainingBudget():
+    has_deadline(false),
+    max_memory(0),
+    memory_used(0),
+    exhausted(false) {}
+
+TrainingBudget::TrainingBudget(double max_seconds,
+                               size_t max_memory):
+    has_deadline(max_seconds > 0),
+    max_memory(max_memory),
+    memory_used(0),
+    exhausted(false) {
+  if (max_seconds < 0) {
+    throw std::runtime_error("The training time budget must be non-negative.");
+  }
+  std::chrono::duration<double> duration(max_seconds);
+  deadline = std::chrono::steady_clock::now()
+      + std::chrono::duration_cast<std::chrono::steady_clock::duration>(duration);
+}
+
+bool TrainingBudget::is_exhausted() const {
+  if (exhausted.load(std::memory_order_relaxed)) {
+    return true;
+  }
+  if (has_deadline && std::chrono::steady_clock::now() >= deadline) {
+    exhausted.store(true, std::memory_order_relaxed);
+    return true;
+  }
+  return false;
+}
+
+bool TrainingBudget::reserve_memory(size_t memory) {
+  if (max_memory == 0) {
+    memory_used += memory;
+    return true;
+  }
+
+  size_t used = memory_used.load();
+  do {
+    if (used + memory > max_memory) {
+      exhausted.store(true, std::memory_order_relaxed);
+      return false;
+    }
+  } while (!memory_used.compare_exchange_weak(used, used + memory));
+  return true;
+}
+
+size_t TrainingBudget::get_memory_used() const {
+  return memory_used.load();
+}
+
+} // namespace grf
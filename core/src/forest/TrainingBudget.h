@@ -0,0 +1,85 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_TRAININGBUDGET_H
+#define GRF_TRAININGBUDGET_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+#include "commons/globals.h"
+
+namespace grf {
+
+/**
+ * A wall-clock and memory budget for training a forest.
+ *
+ * The budget is shared by all training threads, which check it cooperatively: tree
+ * growing stops at the next node once the deadline has passed, and each completed
+ * tree group must reserve its estimated memory before it is added to the forest.
+ * Groups that are interrupted or do not fit are discarded, so the forest only
+ * contains complete tree groups.
+ */
+class TrainingBudget {
+public:
+  /**
+   * Creates a budget without any limits.
+   */
+  TrainingBudget();
+
+  /**
+   * @param max_seconds The wall-clock time available for training, measured from the
+   * construction of this object. A value of 0 means no time limit.
+   * @param max_memory The memory (in bytes) the trained trees may use. A value of 0
+   * means no memory limit.
+   */
+  TrainingBudget(double max_seconds,
+                 size_t max_memory);
+
+  /**
+   * Returns true if the deadline has passed, or if a tree group has
+   * previously been rejected because it did not fit in memory.
+   */
+  bool is_exhausted() const;
+
+  /**
+   * Attempts to reserve memory for a completed tree group. If this would exceed
+   * the memory limit, nothing is reserved, the budget is marked as exhausted, and
+   * false is returned.
+   */
+  bool reserve_memory(size_t memory);
+
+  /**
+   * The estimated memory (in bytes) of all tree groups accepted so far.
+   */
+  size_t get_memory_used() const;
+
+private:
+  bool has_deadline;
+  std::chrono::steady_clock::time_point deadline;
+  size_t max_memory;
+
+  std::atomic<size_t> memory_used;
+  mutable std::atomic<bool> exhausted;
+
+  DISALLOW_COPY_AND_ASSIGN(TrainingBudget);
+};
+
+} // namespace grf
+
+#endif //GRF_TRAININGBUDGET_H
@@ -38,7 +38,7 @@ std::vector<double> CausalSurvivalPredictionStrategy::predict(const std::vector<
 
 std::vector<double> CausalSurvivalPredictionStrategy::compute_variance(
     const std::vector<double>& average,
-    const PredictionValues& leaf_values,
+    const PredictionValuesView& leaf_values,
     size_t ci_group_size) const {
 
   double v_est = average.at(DENOMINATOR);
@@ -65,9 +65,9 @@ std::vector<double> CausalSurvivalPredictionStrategy::compute_variance(
     for (size_t j = 0; j < ci_group_size; ++j) {
 
       size_t i = group * ci_group_size + j;
-      const std::vector<double>& leaf_value = leaf_values.get_values(i);
+      const double* leaf_value = leaf_values.get_row(i);
 
-      double psi_1 = leaf_value.at(NUMERATOR) - leaf_value.at(DENOMINATOR) * average_eta;
+      double psi_1 = leaf_value[NUMERATOR] - leaf_value[DENOMINATOR] * average_eta;
 
       psi_squared += psi_1 * psi_1;
       group_psi += psi_1;
@@ -140,7 +140,7 @@ PredictionValues CausalSurvivalPredictionStrategy::precompute_prediction_values(
 std::vector<std::pair<double, double>> CausalSurvivalPredictionStrategy::compute_error(
     size_t sample,
     const std::vector<double>& average,
-    const PredictionValues& leaf_values,
+    const PredictionValuesView& leaf_values,
     const Data& data) const {
   return { std::make_pair<double, double>(NAN, NAN) };
 }
@@ -25,6 +25,7 @@
 #include "prediction/Prediction.h"
 #include "prediction/OptimizedPredictionStrategy.h"
 #include "prediction/PredictionValues.h"
+#include "prediction/PredictionValuesView.h"
 #include "ObjectiveBayesDebiaser.h"
 
 namespace grf {
@@ -45,13 +46,13 @@ public:
   std::vector<double> predict(const std::vector<double>& average) const;
 
   std::vector<double> compute_variance(const std::vector<double>& average,
-                          const PredictionValues& leaf_values,
+                          const PredictionValuesView& leaf_values,
                           size_t ci_group_size) const;
 
   std::vector<std::pair<double, double>> compute_error(
       size_t sample,
       const std::vector<double>& average,
-      const PredictionValues& leaf_values,
+      const PredictionValuesView& leaf_values,
       const Data& data) const;
 
 private:
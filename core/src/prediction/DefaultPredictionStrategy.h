@@ -18,7 +18,7 @@
 #ifndef GRF_DEFAULTPREDICTIONSTRATEGY_H
 #define GRF_DEFAULTPREDICTIONSTRATEGY_H
 
-#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "commons/globals.h"
@@ -49,15 +49,15 @@ public:
    * Computes a prediction for a single test sample.
    *
    * sample: the ID of the test sample.
-   * weights_by_sample: a map from neighboring sample ID, to a weight specifying
-   *     how often the sample appeared in the same leaf as the test sample. Note that
-   *     these weights are normalized and will sum to 1.
+   * weights_by_sample: a list of neighboring sample IDs, each with a weight specifying
+   *     how often the sample appeared in the same leaf as the test sample. The list is
+   *     sorted by sample ID, and the weights are normalized and will sum to 1.
    * train_data: the training data matrix.
    * data: the test data matrix. Note that in the case of OOB prediction, this could
    *     be the same as the training matrix.
    */
   virtual std::vector<double> predict(size_t sample,
-    const std::unordered_map<size_t, double>& weights_by_sample,
+    const std::vector<std::pair<size_t, double>>& weights_by_sample,
     const Data& train_data,
     const Data& data) const = 0;
 
@@ -67,9 +67,9 @@ public:
    * sample: the ID of the test sample.
    * samples_by_tree: vector of samples in the same leaf as the test point,
    *    for each tree
-   * weights_by_sampleID: a map from neighboring sample ID, to a weight specifying
-   *     how often the sample appeared in the same leaf as the test sample. Note that
-   *     these weights are normalized and will sum to 1.
+   * weights_by_sampleID: a list of neighboring sample IDs, each with a weight specifying
+   *     how often the sample appeared in the same leaf as the test sample. The list is
+   *     sorted by sample ID, and the weights are normalized and will sum to 1.
    * train_data: the training data matrix.
    * data: the test data matrix. Note that in the case of OOB prediction, this could
    *     be the same as the training matrix.
@@ -79,7 +79,7 @@ public:
   virtual std::vector<double> compute_variance(
       size_t sample,
       const std::vector<std::vector<size_t>>& samples_by_tree,
-      const std::unordered_map<size_t, double>& weights_by_sampleID,
+      const std::vector<std::pair<size_t, double>>& weights_by_sampleID,
       const Data& train_data,
       const Data& data,
       size_t ci_group_size) const = 0;
@@ -80,7 +80,7 @@ std::vector<double> InstrumentalPredictionStrategy::predict(const std::vector<do
  */
 std::vector<double> InstrumentalPredictionStrategy::compute_variance(
     const std::vector<double>& average,
-    const PredictionValues& leaf_values,
+    const PredictionValuesView& leaf_values,
     size_t ci_group_size) const {
 
   double instrument_effect_numerator = average.at(OUTCOME_INSTRUMENT) * average.at(WEIGHT)
@@ -111,14 +111,14 @@ std::vector<double> InstrumentalPredictionStrategy::compute_variance(
     for (size_t j = 0; j < ci_group_size; ++j) {
 
       size_t i = group * ci_group_size + j;
-      const std::vector<double>& leaf_value = leaf_values.get_values(i);
+      const double* leaf_value = leaf_values.get_row(i);
 
-      double psi_1 = leaf_value.at(OUTCOME_INSTRUMENT)
-                     - leaf_value.at(TREATMENT_INSTRUMENT) * treatment_effect_estimate
-                     - leaf_value.at(INSTRUMENT) * main_effect_estimate;
-      double psi_2 = leaf_value.at(OUTCOME)
-                     - leaf_value.at(TREATMENT) * treatment_effect_estimate
-                     - leaf_value.at(WEIGHT) * main_effect_estimate;
+      double psi_1 = leaf_value[OUTCOME_INSTRUMENT]
+                     - leaf_value[TREATMENT_INSTRUMENT] * treatment_effect_estimate
+                     - leaf_value[INSTRUMENT] * main_effect_estimate;
+      double psi_2 = leaf_value[OUTCOME]
+                     - leaf_value[TREATMENT] * treatment_effect_estimate
+                     - leaf_value[WEIGHT] * main_effect_estimate;
 
       double rho = (average.at(WEIGHT) * psi_1 - average.at(INSTRUMENT) * psi_2)
           / first_stage_numerator;
@@ -204,7 +204,7 @@ PredictionValues InstrumentalPredictionStrategy::precompute_prediction_values(
 std::vector<std::pair<double, double>> InstrumentalPredictionStrategy::compute_error(
     size_t sample,
     const std::vector<double>& average,
-    const PredictionValues& leaf_values,
+    const PredictionValuesView& leaf_values,
     const Data& data) const {
 
   double reduced_form_numerator = average.at(OUTCOME_INSTRUMENT) * average.at(WEIGHT)
@@ -244,12 +244,12 @@ std::vector<std::pair<double, double>> InstrumentalPredictionStrategy::compute_e
     if (leaf_values.empty(n)) {
       continue;
     }
-    const std::vector<double>& leaf_value = leaf_values.get_values(n);
-    double weight_loto = (num_trees * average.at(WEIGHT) - leaf_value.at(WEIGHT)) / (num_trees - 1);
-    double outcome_loto = (num_trees * average.at(OUTCOME) - leaf_value.at(OUTCOME)) / (num_trees - 1);
-    double instrument_loto = (num_trees * average.at(INSTRUMENT) - leaf_value.at(INSTRUMENT)) / (num_trees - 1);
-    double outcome_instrument_loto = (num_trees * average.at(OUTCOME_INSTRUMENT) - leaf_value.at(OUTCOME_INSTRUMENT)) / (num_trees - 1);
-    double instrument_instrument_loto = (num_trees * average.at(INSTRUMENT_INSTRUMENT) - leaf_value.at(INSTRUMENT_INSTRUMENT)) / (num_trees - 1);
+    const double* leaf_value = leaf_values.get_row(n);
+    double weight_loto = (num_trees * average.at(WEIGHT) - leaf_value[WEIGHT]) / (num_trees - 1);
+    double outcome_loto = (num_trees * average.at(OUTCOME) - leaf_value[OUTCOME]) / (num_trees - 1);
+    double instrument_loto = (num_trees * average.at(INSTRUMENT) - leaf_value[INSTRUMENT]) / (num_trees - 1);
+    double outcome_instrument_loto = (num_trees * average.at(OUTCOME_INSTRUMENT) - leaf_value[OUTCOME_INSTRUMENT]) / (num_trees - 1);
+    double instrument_instrument_loto = (num_trees * average.at(INSTRUMENT_INSTRUMENT) - leaf_value[INSTRUMENT_INSTRUMENT]) / (num_trees - 1);
 
     double reduced_form_numerator_loto = outcome_instrument_loto * weight_loto - outcome_loto * instrument_loto;
     double reduced_form_denominator_loto = instrument_instrument_loto * weight_loto - instrument_loto * instrument_loto;
@@ -20,6 +20,7 @@
 #include "commons/utility.h"
 #include "commons/Data.h"
 #include "prediction/LLCausalPredictionStrategy.h"
+#include "prediction/RidgePathSolver.h"
 
 namespace grf {
 
@@ -37,7 +38,7 @@ size_t LLCausalPredictionStrategy::prediction_length() const {
 
 std::vector<double> LLCausalPredictionStrategy::predict(
         size_t sampleID,
-        const std::unordered_map<size_t, double>& weights_by_sampleID,
+        const std::vector<std::pair<size_t, double>>& weights_by_sampleID,
         const Data& train_data,
         const Data& test_data) const {
 
@@ -45,7 +46,6 @@ std::vector<double> LLCausalPredictionStrategy::predict(
   size_t num_variables = linear_correction_variables.size();
 
   size_t num_nonzero_weights = weights_by_sampleID.size();
-  size_t num_lambdas = lambdas.size();
 
   // Creating a vector of neighbor weights weights
   // Weights by sample ID contains pairs [sample ID, weight for test point]
@@ -108,32 +108,44 @@ std::vector<double> LLCausalPredictionStrategy::predict(
   // find ridge regression predictions
   Eigen::MatrixXd M_unpenalized (dim_X, dim_X);
   M_unpenalized.noalias() = X.transpose() * weights_vec.asDiagonal() * X;
+  Eigen::VectorXd weighted_outcomes = X.transpose() * weights_vec.asDiagonal() * Y;
 
-  std::vector<double> predictions(num_lambdas);
-  Eigen::MatrixXd M;
+  return predict(M_unpenalized, weighted_outcomes);
+}
 
-  for (size_t i = 0; i < num_lambdas; ++i){
-    double lambda = lambdas[i];
-    M = M_unpenalized;
-    if (!weight_penalty) {
-      double normalization = M_unpenalized.trace() / dim_X;
-
-      // standard ridge penalty
-      for (size_t j = 1; j < dim_X; ++j){
-        if (j != treatment_index){
-          M(j, j) += lambda * normalization;
-        }
+std::vector<double> LLCausalPredictionStrategy::predict(
+        const Eigen::MatrixXd& M_unpenalized,
+        const Eigen::VectorXd& weighted_outcomes) const {
+  size_t num_variables = linear_correction_variables.size();
+  size_t num_lambdas = lambdas.size();
+  size_t dim_X = 2 * num_variables + 2;
+  size_t treatment_index = num_variables + 1;
+
+  // Neither the intercept nor the treatment is penalized.
+  Eigen::VectorXd penalty = Eigen::VectorXd::Zero(dim_X);
+  if (!weight_penalty) {
+    double normalization = M_unpenalized.trace() / dim_X;
+
+    // standard ridge penalty
+    for (size_t j = 1; j < dim_X; ++j){
+      if (j != treatment_index){
+        penalty(j) = normalization;
       }
-    } else {
-      // covariance ridge penalty
-      for (size_t j = 1; j < dim_X; ++j){
-        if (j != treatment_index){
-          M(j, j) += lambda * M(j, j);
-        }
+    }
+  } else {
+    // covariance ridge penalty
+    for (size_t j = 1; j < dim_X; ++j){
+      if (j != treatment_index){
+        penalty(j) = M_unpenalized(j, j);
       }
     }
+  }
 
-    Eigen::MatrixXd local_coefficients = M.ldlt().solve(X.transpose()*weights_vec.asDiagonal()*Y);
+  // One decomposition serves the whole regularization path.
+  RidgePathSolver solver(M_unpenalized, weighted_outcomes, penalty, {0, treatment_index});
+  std::vector<double> predictions(num_lambdas);
+  for (size_t i = 0; i < num_lambdas; ++i){
+    Eigen::VectorXd local_coefficients = solver.solve(lambdas[i]);
 
     // We're only interested in the coefficient associated with the treatment variable
     predictions[i] = local_coefficients(treatment_index);
@@ -145,7 +157,7 @@ std::vector<double> LLCausalPredictionStrategy::predict(
 std::vector<double> LLCausalPredictionStrategy::compute_variance(
         size_t sampleID,
         const std::vector<std::vector<size_t>>& samples_by_tree,
-        const std::unordered_map<size_t, double>& weights_by_sampleID,
+        const std::vector<std::pair<size_t, double>>& weights_by_sampleID,
         const Data& train_data,
         const Data& test_data,
         size_t ci_group_size) const {
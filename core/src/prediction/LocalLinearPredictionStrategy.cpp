@@ -20,6 +20,7 @@
 #include "commons/utility.h"
 #include "commons/Data.h"
 #include "prediction/LocalLinearPredictionStrategy.h"
+#include "prediction/RidgePathSolver.h"
 
 namespace grf {
 
@@ -37,7 +38,7 @@ size_t LocalLinearPredictionStrategy::prediction_length() const {
 
 std::vector<double> LocalLinearPredictionStrategy::predict(
     size_t sampleID,
-    const std::unordered_map<size_t, double>& weights_by_sampleID,
+    const std::vector<std::pair<size_t, double>>& weights_by_sampleID,
     const Data& train_data,
     const Data& data) const {
   size_t num_variables = linear_correction_variables.size();
@@ -71,29 +72,37 @@ std::vector<double> LocalLinearPredictionStrategy::predict(
   // find ridge regression predictions
   Eigen::MatrixXd M_unpenalized(num_variables+1, num_variables+1);
   M_unpenalized.noalias() = X.transpose()*weights_vec.asDiagonal()*X;
+  Eigen::VectorXd weighted_outcomes = X.transpose()*weights_vec.asDiagonal()*Y;
 
-  Eigen::MatrixXd M;
-  size_t num_lambdas = lambdas.size();
-  std::vector<double> predictions(num_lambdas);
+  return predict(M_unpenalized, weighted_outcomes);
+}
 
-  for (size_t i = 0; i < num_lambdas; ++i){
-    double lambda = lambdas[i];
-    M = M_unpenalized;
-
-    if (!weight_penalty) {
-      // standard ridge penalty
-      double normalization = M.trace() / (num_variables + 1);
-      for (size_t j = 1; j < num_variables + 1; ++j){
-        M(j,j) += lambda * normalization;
-      }
-    } else {
-      // covariance ridge penalty
-      for (size_t j = 1; j < num_variables+1; ++j){
-        M(j,j) += lambda * M(j,j); // note that the weights are already normalized
-      }
+std::vector<double> LocalLinearPredictionStrategy::predict(
+    const Eigen::MatrixXd& M_unpenalized,
+    const Eigen::VectorXd& weighted_outcomes) const {
+  size_t num_variables = linear_correction_variables.size();
+
+  // The intercept is never penalized.
+  Eigen::VectorXd penalty = Eigen::VectorXd::Zero(num_variables + 1);
+  if (!weight_penalty) {
+    // standard ridge penalty
+    double normalization = M_unpenalized.trace() / (num_variables + 1);
+    for (size_t j = 1; j < num_variables + 1; ++j){
+      penalty(j) = normalization;
+    }
+  } else {
+    // covariance ridge penalty
+    for (size_t j = 1; j < num_variables+1; ++j){
+      penalty(j) = M_unpenalized(j,j); // note that the weights are already normalized
     }
+  }
 
-    Eigen::MatrixXd local_coefficients = M.ldlt().solve(X.transpose()*weights_vec.asDiagonal()*Y);
+  // One decomposition serves the whole regularization path.
+  RidgePathSolver solver(M_unpenalized, weighted_outcomes, penalty, {0});
+  size_t num_lambdas = lambdas.size();
+  std::vector<double> predictions(num_lambdas);
+  for (size_t i = 0; i < num_lambdas; ++i){
+    Eigen::VectorXd local_coefficients = solver.solve(lambdas[i]);
     predictions[i] =  local_coefficients(0);
   }
 
@@ -103,7 +112,7 @@ std::vector<double> LocalLinearPredictionStrategy::predict(
 std::vector<double> LocalLinearPredictionStrategy::compute_variance(
     size_t sampleID,
     const std::vector<std::vector<size_t>>& samples_by_tree,
-    const std::unordered_map<size_t, double>& weights_by_sampleID,
+    const std::vector<std::pair<size_t, double>>& weights_by_sampleID,
     const Data& train_data,
     const Data& data,
     size_t ci_group_size) const {
@@ -20,7 +20,8 @@
 
 
 #include <cstddef>
-#include <unordered_map>
+#include <utility>
+#include <vector>
 #include "Eigen/Dense"
 #include "commons/Data.h"
 #include "prediction/Prediction.h"
@@ -46,14 +47,24 @@ public:
     *   output predictions along each of these parameters.
     */
     std::vector<double> predict(size_t sampleID,
-                                const std::unordered_map<size_t, double>& weights_by_sampleID,
+                                const std::vector<std::pair<size_t, double>>& weights_by_sampleID,
                                 const Data& train_data,
                                 const Data& data) const;
 
+    /**
+    * Computes the regularization path from the weighted moments of the local design, whose
+    * columns are an intercept and the linear correction variables centered at the test sample.
+    *
+    * M_unpenalized: the weighted Gram matrix X'WX of the design, with forest weights summing to one
+    * weighted_outcomes: the weighted outcomes X'WY
+    */
+    std::vector<double> predict(const Eigen::MatrixXd& M_unpenalized,
+                                const Eigen::VectorXd& weighted_outcomes) const;
+
     std::vector<double> compute_variance(
         size_t sampleID,
         const std::vector<std::vector<size_t>>& samples_by_tree,
-        const std::unordered_map<size_t, double>& weights_by_sampleID,
+        const std::vector<std::pair<size_t, double>>& weights_by_sampleID,
         const Data& train_data,
         const Data& data,
         size_t ci_group_size) const;
@@ -81,7 +81,7 @@ std::vector<double> MultiCausalPredictionStrategy::predict(const std::vector<dou
  */
 std::vector<double> MultiCausalPredictionStrategy::compute_variance(
     const std::vector<double>& average,
-    const PredictionValues& leaf_values,
+    const PredictionValuesView& leaf_values,
     size_t ci_group_size) const {
   if (num_outcomes > 1) {
     throw std::runtime_error("Pointwise variance estimates are only implemented for one outcome.");
@@ -123,12 +123,12 @@ std::vector<double> MultiCausalPredictionStrategy::compute_variance(
     for (size_t j = 0; j < ci_group_size; ++j) {
 
       size_t i = group * ci_group_size + j;
-      const std::vector<double>& leaf_value = leaf_values.get_values(i);
+      const double* leaf_value = leaf_values.get_row(i);
       double leaf_weight = leaf_value[weight_index];
       double leaf_Y = leaf_value[Y_index];
-      Eigen::Map<const Eigen::VectorXd> leaf_W(leaf_value.data() + W_index, num_treatments);
-      Eigen::Map<const Eigen::VectorXd> leaf_YW(leaf_value.data() + YW_index, num_treatments);
-      Eigen::Map<const Eigen::MatrixXd> leaf_WW(leaf_value.data() + WW_index, num_treatments, num_treatments);
+      Eigen::Map<const Eigen::VectorXd> leaf_W(leaf_value + W_index, num_treatments);
+      Eigen::Map<const Eigen::VectorXd> leaf_YW(leaf_value + YW_index, num_treatments);
+      Eigen::Map<const Eigen::MatrixXd> leaf_WW(leaf_value + WW_index, num_treatments, num_treatments);
 
       psi_1 = leaf_YW - leaf_WW * theta - leaf_W * main_effect;
       double psi_2 = leaf_Y - leaf_W.transpose() * theta - leaf_weight * main_effect;
@@ -222,7 +222,7 @@ PredictionValues MultiCausalPredictionStrategy::precompute_prediction_values(
 std::vector<std::pair<double, double>> MultiCausalPredictionStrategy::compute_error(
     size_t sample,
     const std::vector<double>& average,
-    const PredictionValues& leaf_values,
+    const PredictionValuesView& leaf_values,
     const Data& data) const {
   return { std::make_pair<double, double>(NAN, NAN) };
 }
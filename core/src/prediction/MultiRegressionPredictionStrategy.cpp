@@ -44,7 +44,7 @@ std::vector<double> MultiRegressionPredictionStrategy::predict(const std::vector
 
 std::vector<double> MultiRegressionPredictionStrategy::compute_variance(
     const std::vector<double>& average,
-    const PredictionValues& leaf_values,
+    const PredictionValuesView& leaf_values,
     size_t ci_group_size) const {
   return { 0.0 };
 }
@@ -94,7 +94,7 @@ PredictionValues MultiRegressionPredictionStrategy::precompute_prediction_values
 std::vector<std::pair<double, double>> MultiRegressionPredictionStrategy::compute_error(
     size_t sample,
     const std::vector<double>& average,
-    const PredictionValues& leaf_values,
+    const PredictionValuesView& leaf_values,
     const Data& data) const {
   return { std::make_pair<double, double>(NAN, NAN) };
 }
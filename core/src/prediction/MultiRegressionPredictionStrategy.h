@@ -21,6 +21,7 @@
 #include "commons/Data.h"
 #include "prediction/OptimizedPredictionStrategy.h"
 #include "prediction/PredictionValues.h"
+#include "prediction/PredictionValuesView.h"
 #include "ObjectiveBayesDebiaser.h"
 
 namespace grf {
@@ -40,13 +41,13 @@ public:
 
   std::vector<double> compute_variance(
       const std::vector<double>& average,
-      const PredictionValues& leaf_values,
+      const PredictionValuesView& leaf_values,
       size_t ci_group_size) const;
 
   std::vector<std::pair<double, double>> compute_error(
       size_t sample,
       const std::vector<double>& average,
-      const PredictionValues& leaf_values,
+      const PredictionValuesView& leaf_values,
       const Data& data) const;
 
 private:
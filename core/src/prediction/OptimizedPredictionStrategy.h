@@ -24,6 +24,7 @@
 #include "commons/Data.h"
 #include "prediction/Prediction.h"
 #include "prediction/PredictionValues.h"
+#include "prediction/PredictionValuesView.h"
 
 namespace grf {
 
@@ -68,7 +69,7 @@ public:
   */
   virtual std::vector<double> compute_variance(
       const std::vector<double>& average_prediction_values,
-      const PredictionValues& leaf_prediction_values,
+      const PredictionValuesView& leaf_prediction_values,
       size_t ci_group_size) const = 0;
 
  /**
@@ -104,7 +105,7 @@ public:
   virtual std::vector<std::pair<double, double>> compute_error(
       size_t sample,
       const std::vector<double>& average,
-      const PredictionValues& leaf_values,
+      const PredictionValuesView& leaf_values,
       const Data& data) const = 0;
 };
 
@@ -15,36 +15,57 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
+#include <stdexcept>
+
 #include "prediction/PredictionValues.h"
 
 namespace grf {
 
+const size_t PredictionValues::EMPTY_ROW = std::numeric_limits<size_t>::max();
+
 PredictionValues::PredictionValues():
   num_nodes(0),
   num_types(0) {}
 
 PredictionValues::PredictionValues(const std::vector<std::vector<double>>& values,
                                    size_t num_types):
-  values(values),
+  row_offsets(values.size(), EMPTY_ROW),
   num_nodes(values.size()),
-  num_types(num_types) {}
-
-
-
-double PredictionValues::get(std::size_t node, size_t type) const {
-  return values.at(node).at(type);
+  num_types(num_types) {
+  size_t num_rows = 0;
+  for (const auto& node_values : values) {
+    if (node_values.empty()) {
+      continue;
+    }
+    if (node_values.size() != num_types) {
+      throw std::runtime_error("Every non-empty node must have num_types prediction values.");
+    }
+    num_rows++;
+  }
+
+  this->values.reserve(num_rows * num_types);
+  for (size_t node = 0; node < num_nodes; ++node) {
+    if (!values[node].empty()) {
+      row_offsets[node] = this->values.size();
+      this->values.insert(this->values.end(), values[node].begin(), values[node].end());
+    }
+  }
 }
 
-const std::vector<double>& PredictionValues::get_values(std::size_t node) const {
-  return values.at(node);
+std::vector<double> PredictionValues::get_values(std::size_t node) const {
+  if (empty(node)) {
+    return std::vector<double>();
+  }
+  const double* row = get_row(node);
+  return std::vector<double>(row, row + num_types);
 }
 
-bool PredictionValues::empty(std::size_t node) const {
-  return values.at(node).empty();
-}
-
-const std::vector<std::vector<double>>& PredictionValues::get_all_values() const {
-  return values;
+std::vector<std::vector<double>> PredictionValues::get_all_values() const {
+  std::vector<std::vector<double>> all_values(num_nodes);
+  for (size_t node = 0; node < num_nodes; ++node) {
+    all_values[node] = get_values(node);
+  }
+  return all_values;
 }
 
 const size_t PredictionValues::get_num_nodes() const {
@@ -55,4 +76,8 @@ const size_t PredictionValues::get_num_types() const {
   return num_types;
 }
 
+size_t PredictionValues::estimate_memory_usage() const {
+  return values.capacity() * sizeof(double) + row_offsets.capacity() * sizeof(size_t);
+}
+
 } // namespace grf
@@ -19,10 +19,18 @@
 #define GRF_PREDICTIONVALUES_H
 
 #include <cstddef>
+#include <limits>
 #include <vector>
 
 namespace grf {
 
+/**
+ * Summary values for a set of nodes, with num_types values per non-empty node.
+ *
+ * The values are stored as a single dense buffer with one row of num_types values per
+ * non-empty node, and each node holds the offset of its row. To read the rows of
+ * nodes from several trees at once, see PredictionValuesView.
+ */
 class PredictionValues {
 public:
   PredictionValues();
@@ -30,25 +38,59 @@ public:
   PredictionValues(const std::vector<std::vector<double>>& values,
                    size_t num_types);
 
-
+  /**
+   * Returns the value of the given type for a node. Note that for efficiency
+   * this is not bounds-checked, and the node must not be empty.
+   */
   double get(size_t node, size_t type) const;
-  const std::vector<double>& get_values(size_t node) const;
+
+  /**
+   * Returns a pointer to the num_types values for a node, or nullptr if the node is empty.
+   */
+  const double* get_row(size_t node) const;
+
+  /**
+   * Returns a copy of the values for a node, which is empty if the node is empty.
+   */
+  std::vector<double> get_values(size_t node) const;
+
   bool empty(size_t node) const;
 
   /**
    *  Returns all prediction values in this object. Values are
    *  organized first by node, then by type.
    */
-  const std::vector<std::vector<double>>& get_all_values() const;
+  std::vector<std::vector<double>> get_all_values() const;
   const size_t get_num_nodes() const;
   const size_t get_num_types() const;
 
+  /**
+   * The memory (in bytes) used by the values and row offsets.
+   */
+  size_t estimate_memory_usage() const;
+
 private:
-  std::vector<std::vector<double>> values;
+  static const size_t EMPTY_ROW;
+
+  std::vector<double> values;
+  std::vector<size_t> row_offsets;
   size_t num_nodes;
   size_t num_types;
 };
 
+// inline the accessors used in the prediction hot loops
+inline double PredictionValues::get(size_t node, size_t type) const {
+  return values[row_offsets[node] + type];
+}
+
+inline const double* PredictionValues::get_row(size_t node) const {
+  return empty(node) ? nullptr : values.data() + row_offsets[node];
+}
+
+inline bool PredictionValues::empty(size_t node) const {
+  return row_offsets[node] == EMPTY_ROW;
+}
+
 } // namespace grf
 
 #endif //GRF_PREDICTIONVALUES_H
@@ -0,0 +1,43 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include "prediction/PredictionValuesView.h"
+
+namespace grf {
+
+PredictionValuesView::PredictionValuesView(size_t num_nodes,
+                                           size_t num_types):
+  rows(num_nodes, nullptr),
+  num_types(num_types) {}
+
+PredictionValuesView::PredictionValuesView(const PredictionValues& prediction_values):
+  rows(prediction_values.get_num_nodes()),
+  num_types(prediction_values.get_num_types()) {
+  for (size_t node = 0; node < rows.size(); ++node) {
+    rows[node] = prediction_values.get_row(node);
+  }
+}
+
+size_t PredictionValuesView::get_num_nodes() const {
+  return rows.size();
+}
+
+size_t PredictionValuesView::get_num_types() const {
+  return num_types;
+}
+
+} // namespace grf
@@ -0,0 +1,94 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_PREDICTIONVALUESVIEW_H
+#define GRF_PREDICTIONVALUESVIEW_H
+
+#include <cstddef>
+#include <vector>
+
+#include "prediction/PredictionValues.h"
+
+namespace grf {
+
+/**
+ * A non-owning view of rows of prediction values, with num_types values per non-empty
+ * node. The prediction collectors use it to gather the leaf values of every tree a test
+ * sample falls into without copying them. A view is only valid as long as the values it
+ * points at are.
+ */
+class PredictionValuesView {
+public:
+  /**
+   * Creates a view with num_nodes empty nodes, whose rows can then be pointed at
+   * values owned elsewhere through set_row.
+   */
+  PredictionValuesView(size_t num_nodes,
+                       size_t num_types);
+
+  /**
+   * Creates a view of all nodes of the given prediction values.
+   */
+  PredictionValuesView(const PredictionValues& prediction_values);
+
+  /**
+   * Returns the value of the given type for a node. Note that for efficiency
+   * this is not bounds-checked, and the node must not be empty.
+   */
+  double get(size_t node, size_t type) const;
+
+  /**
+   * Returns a pointer to the num_types values for a node, or nullptr if the node is empty.
+   */
+  const double* get_row(size_t node) const;
+
+  bool empty(size_t node) const;
+
+  /**
+   * Points the given node at a row of num_types values, or marks it as empty if
+   * row is nullptr.
+   */
+  void set_row(size_t node, const double* row);
+
+  size_t get_num_nodes() const;
+  size_t get_num_types() const;
+
+private:
+  std::vector<const double*> rows;
+  size_t num_types;
+};
+
+// inline the accessors used in the prediction hot loops
+inline double PredictionValuesView::get(size_t node, size_t type) const {
+  return rows[node][type];
+}
+
+inline const double* PredictionValuesView::get_row(size_t node) const {
+  return rows[node];
+}
+
+inline bool PredictionValuesView::empty(size_t node) const {
+  return rows[node] == nullptr;
+}
+
+inline void PredictionValuesView::set_row(size_t node, const double* row) {
+  rows[node] = row;
+}
+
+} // namespace grf
+
+#endif //GRF_PREDICTIONVALUESVIEW_H
@@ -42,7 +42,7 @@ std::vector<double> ProbabilityPredictionStrategy::predict(const std::vector<dou
 
 std::vector<double> ProbabilityPredictionStrategy::compute_variance(
     const std::vector<double>& average,
-    const PredictionValues& leaf_values,
+    const PredictionValuesView& leaf_values,
     size_t ci_group_size) const {
   std::vector<double> variance_estimates(num_classes);
   double weight_bar = average[weight_index];
@@ -139,7 +139,7 @@ PredictionValues ProbabilityPredictionStrategy::precompute_prediction_values(
 std::vector<std::pair<double, double>> ProbabilityPredictionStrategy::compute_error(
     size_t sample,
     const std::vector<double>& average,
-    const PredictionValues& leaf_values,
+    const PredictionValuesView& leaf_values,
     const Data& data) const {
   return { std::make_pair<double, double>(NAN, NAN) };
 }
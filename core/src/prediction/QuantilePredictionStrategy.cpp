@@ -33,20 +33,23 @@ size_t QuantilePredictionStrategy::prediction_length() const {
 
 std::vector<double> QuantilePredictionStrategy::predict(
     size_t prediction_sample,
-    const std::unordered_map<size_t, double>& weights_by_sample,
+    const std::vector<std::pair<size_t, double>>& weights_by_sample,
     const Data& train_data,
     const Data& data) const {
+  // Neighbors are referred to by their position in weights_by_sample, which is
+  // sorted by sample ID, so the tie-breaker below still orders by sample ID.
   std::vector<std::pair<size_t, double>> samples_and_values;
-  for (const auto& entry : weights_by_sample) {
-    size_t sample = entry.first;
-    samples_and_values.emplace_back(sample, train_data.get_outcome(sample));
+  samples_and_values.reserve(weights_by_sample.size());
+  for (size_t i = 0; i < weights_by_sample.size(); ++i) {
+    size_t sample = weights_by_sample[i].first;
+    samples_and_values.emplace_back(i, train_data.get_outcome(sample));
   }
 
   return compute_quantile_cutoffs(weights_by_sample, samples_and_values);
 }
 
 std::vector<double> QuantilePredictionStrategy::compute_quantile_cutoffs(
-    const std::unordered_map<size_t, double>& weights_by_sample,
+    const std::vector<std::pair<size_t, double>>& weights_by_sample,
     std::vector<std::pair<size_t, double>>& samples_and_values) const {
   std::sort(samples_and_values.begin(),
             samples_and_values.end(),
@@ -63,10 +66,10 @@ std::vector<double> QuantilePredictionStrategy::compute_quantile_cutoffs(
   double cumulative_weight = 0.0;
 
   for (const auto& entry : samples_and_values) {
-    size_t sample = entry.first;
+    size_t position = entry.first;
     double value = entry.second;
 
-    cumulative_weight += weights_by_sample.at(sample);
+    cumulative_weight += weights_by_sample[position].second;
     while (quantile_it != quantiles.end() && cumulative_weight >= *quantile_it) {
       quantile_cutoffs.push_back(value);
       ++quantile_it;
@@ -83,7 +86,7 @@ std::vector<double> QuantilePredictionStrategy::compute_quantile_cutoffs(
 std::vector<double> QuantilePredictionStrategy::compute_variance(
     size_t sampleID,
     const std::vector<std::vector<size_t>>& samples_by_tree,
-    const std::unordered_map<size_t, double>& weights_by_sampleID,
+    const std::vector<std::pair<size_t, double>>& weights_by_sampleID,
     const Data& train_data,
     const Data& data,
     size_t ci_group_size) const {
@@ -50,7 +50,7 @@ std::vector<double> RegressionPredictionStrategy::predict(const std::vector<doub
  */
 std::vector<double> RegressionPredictionStrategy::compute_variance(
     const std::vector<double>& average,
-    const PredictionValues& leaf_values,
+    const PredictionValuesView& leaf_values,
     size_t ci_group_size) const {
 
   double average_weight = average.at(WEIGHT);
@@ -141,7 +141,7 @@ PredictionValues RegressionPredictionStrategy::precompute_prediction_values(
 std::vector<std::pair<double, double>> RegressionPredictionStrategy::compute_error(
     size_t sample,
     const std::vector<double>& average,
-    const PredictionValues& leaf_values,
+    const PredictionValuesView& leaf_values,
     const Data& data) const {
   double outcome = data.get_outcome(sample);
 
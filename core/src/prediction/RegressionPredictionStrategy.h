@@ -21,12 +21,16 @@
 #include "commons/Data.h"
 #include "prediction/OptimizedPredictionStrategy.h"
 #include "prediction/PredictionValues.h"
+#include "prediction/PredictionValuesView.h"
 #include "ObjectiveBayesDebiaser.h"
 
 namespace grf {
 
 class RegressionPredictionStrategy final: public OptimizedPredictionStrategy {
 public:
+  static const std::size_t OUTCOME;
+  static const std::size_t WEIGHT;
+
   size_t prediction_value_length() const;
 
   PredictionValues precompute_prediction_values(const std::vector<std::vector<size_t>>& leaf_samples,
@@ -38,18 +42,16 @@ public:
 
   std::vector<double> compute_variance(
       const std::vector<double>& average,
-      const PredictionValues& leaf_values,
+      const PredictionValuesView& leaf_values,
       size_t ci_group_size) const;
 
   std::vector<std::pair<double, double>> compute_error(
       size_t sample,
       const std::vector<double>& average,
-      const PredictionValues& leaf_values,
+      const PredictionValuesView& leaf_values,
       const Data& data) const;
 
 private:
-  static const std::size_t OUTCOME;
-  static const std::size_t WEIGHT;
   ObjectiveBayesDebiaser bayes_debiaser;
 };
 
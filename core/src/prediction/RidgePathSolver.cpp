@@ -0,0 +1,162 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// GCC reports a spurious -Wmaybe-uninitialized inside the tridiagonalization that
+// Eigen's SelfAdjointEigenSolver runs, so it is silenced for the Eigen headers only.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include "Eigen/Dense"
+#pragma GCC diagnostic pop
+#endif
+
+#include "prediction/RidgePathSolver.h"
+
+namespace grf {
+
+RidgePathSolver::RidgePathSolver(const Eigen::MatrixXd& M,
+                                 const Eigen::VectorXd& r,
+                                 const Eigen::VectorXd& penalty,
+                                 const std::vector<size_t>& unpenalized):
+    M(M),
+    r(r),
+    penalty(penalty),
+    unpenalized(unpenalized),
+    decomposed(true),
+    tolerance(0.0) {
+  size_t dimension = M.rows();
+  std::vector<bool> is_unpenalized(dimension, false);
+  for (size_t j : unpenalized) {
+    is_unpenalized[j] = true;
+    this->penalty(j) = 0.0;
+  }
+  for (size_t j = 0; j < dimension; ++j) {
+    if (!is_unpenalized[j]) {
+      penalized.push_back(j);
+      if (penalty(j) <= 0) {
+        decomposed = false;
+      }
+    }
+  }
+  if (!decomposed) {
+    return;
+  }
+  size_t num_unpenalized = unpenalized.size();
+  size_t num_penalized = penalized.size();
+
+  Eigen::MatrixXd M_aa(num_unpenalized, num_unpenalized);
+  Eigen::MatrixXd M_ab(num_unpenalized, num_penalized);
+  Eigen::MatrixXd M_bb(num_penalized, num_penalized);
+  Eigen::VectorXd r_a(num_unpenalized);
+  Eigen::VectorXd r_b(num_penalized);
+  for (size_t i = 0; i < num_unpenalized; ++i) {
+    for (size_t j = 0; j < num_unpenalized; ++j) {
+      M_aa(i, j) = M(unpenalized[i], unpenalized[j]);
+    }
+    for (size_t j = 0; j < num_penalized; ++j) {
+      M_ab(i, j) = M(unpenalized[i], penalized[j]);
+    }
+    r_a(i) = r(unpenalized[i]);
+  }
+  for (size_t i = 0; i < num_penalized; ++i) {
+    for (size_t j = 0; j < num_penalized; ++j) {
+      M_bb(i, j) = M(penalized[i], penalized[j]);
+    }
+    r_b(i) = r(penalized[i]);
+  }
+
+  Eigen::MatrixXd schur_complement = M_bb;
+  Eigen::VectorXd schur_rhs = r_b;
+  if (num_unpenalized > 0) {
+    Eigen::LDLT<Eigen::MatrixXd> unpenalized_ldlt = M_aa.ldlt();
+    Eigen::VectorXd pivots = unpenalized_ldlt.vectorD().cwiseAbs();
+    if (unpenalized_ldlt.info() != Eigen::Success
+        || pivots.minCoeff() <= std::max(pivots.maxCoeff(), 1.0) * num_unpenalized
+            * std::numeric_limits<double>::epsilon()) {
+      decomposed = false;
+      return;
+    }
+    unpenalized_map = unpenalized_ldlt.solve(M_ab);
+    unpenalized_solution = unpenalized_ldlt.solve(r_a);
+    schur_complement.noalias() -= M_ab.transpose() * unpenalized_map;
+    schur_rhs.noalias() -= M_ab.transpose() * unpenalized_solution;
+  }
+
+  if (num_penalized > 0) {
+    scale.resize(num_penalized);
+    for (size_t j = 0; j < num_penalized; ++j) {
+      scale(j) = 1.0 / std::sqrt(penalty(penalized[j]));
+    }
+    Eigen::MatrixXd scaled = scale.asDiagonal() * schur_complement * scale.asDiagonal();
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eigen_solver(scaled);
+    eigenvectors = eigen_solver.eigenvectors();
+    eigenvalues = eigen_solver.eigenvalues();
+    projected_rhs = eigenvectors.transpose() * scale.cwiseProduct(schur_rhs);
+
+    // Lambdas at which a penalized eigenvalue is at the level of rounding error are
+    // solved directly instead.
+    tolerance = std::max(eigenvalues.cwiseAbs().maxCoeff(), 1.0)
+        * num_penalized * std::numeric_limits<double>::epsilon();
+  }
+}
+
+Eigen::VectorXd RidgePathSolver::solve(double lambda) const {
+  if (!decomposed) {
+    return solve_directly(lambda);
+  }
+
+  size_t num_penalized = penalized.size();
+  Eigen::VectorXd beta_b = Eigen::VectorXd::Zero(num_penalized);
+  if (num_penalized > 0) {
+    Eigen::VectorXd coefficients(num_penalized);
+    for (size_t k = 0; k < num_penalized; ++k) {
+      double denominator = eigenvalues(k) + lambda;
+      if (std::abs(denominator) <= tolerance) {
+        return solve_directly(lambda);
+      }
+      coefficients(k) = projected_rhs(k) / denominator;
+    }
+    beta_b = scale.cwiseProduct(eigenvectors * coefficients);
+  }
+
+  Eigen::VectorXd beta = Eigen::VectorXd::Zero(unpenalized.size() + num_penalized);
+  if (!unpenalized.empty()) {
+    Eigen::VectorXd beta_a = unpenalized_solution;
+    if (num_penalized > 0) {
+      beta_a.noalias() -= unpenalized_map * beta_b;
+    }
+    for (size_t i = 0; i < unpenalized.size(); ++i) {
+      beta(unpenalized[i]) = beta_a(i);
+    }
+  }
+  for (size_t j = 0; j < num_penalized; ++j) {
+    beta(penalized[j]) = beta_b(j);
+  }
+  return beta;
+}
+
+Eigen::VectorXd RidgePathSolver::solve_directly(double lambda) const {
+  Eigen::MatrixXd penalized_M = M;
+  penalized_M.diagonal() += lambda * penalty;
+  return penalized_M.ldlt().solve(r);
+}
+
+} // namespace grf
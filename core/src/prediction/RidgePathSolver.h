@@ -0,0 +1,92 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_RIDGEPATHSOLVER_H
+#define GRF_RIDGEPATHSOLVER_H
+
+#include <cstddef>
+#include <vector>
+
+#include "Eigen/Dense"
+
+namespace grf {
+
+/**
+ * Solves the ridge problems (M + lambda * diag(penalty)) beta = r for a whole path of
+ * lambdas, from a single decomposition.
+ *
+ * The unpenalized coefficients, such as an intercept, are profiled out through a Schur
+ * complement. The remaining block is rescaled so that its penalty becomes the identity
+ * and then eigendecomposed, after which each lambda only costs a diagonal solve and two
+ * matrix-vector products, rather than a fresh factorization.
+ *
+ * Degenerate problems are solved with a separate LDLT decomposition of
+ * M + lambda * diag(penalty) for each lambda, so that they get exactly the same solution
+ * as a direct solve. A lambda is degenerate if the unpenalized block is singular, if a
+ * penalized coefficient has a zero penalty (for example a constant column under a
+ * covariance penalty), or if the penalized system is singular at that lambda (for example
+ * collinear columns at lambda = 0).
+ */
+class RidgePathSolver {
+public:
+  /**
+   * M: a symmetric positive semi-definite matrix, such as a weighted Gram matrix X'WX
+   * r: the right-hand side, such as the weighted outcomes X'WY
+   * penalty: the non-negative diagonal of the penalty matrix
+   * unpenalized: the coefficients that are never penalized. Their penalty is ignored,
+   *   while every other coefficient is treated as penalized, even if its penalty is zero.
+   */
+  RidgePathSolver(const Eigen::MatrixXd& M,
+                  const Eigen::VectorXd& r,
+                  const Eigen::VectorXd& penalty,
+                  const std::vector<size_t>& unpenalized);
+
+  /**
+   * Returns the ridge coefficients for the given lambda.
+   */
+  Eigen::VectorXd solve(double lambda) const;
+
+private:
+  Eigen::VectorXd solve_directly(double lambda) const;
+
+  Eigen::MatrixXd M;
+  Eigen::VectorXd r;
+  Eigen::VectorXd penalty;
+
+  std::vector<size_t> unpenalized;
+  std::vector<size_t> penalized;
+
+  // Whether the decomposition below can be used for lambdas where the penalized system
+  // is not singular.
+  bool decomposed;
+
+  // Maps the penalized coefficients to the unpenalized ones: beta_a = s_a - A beta_b.
+  Eigen::MatrixXd unpenalized_map;
+  Eigen::VectorXd unpenalized_solution;
+
+  // The scaled Schur complement is Q diag(eigenvalues) Q', and its right-hand side
+  // in the eigenbasis is projected_rhs.
+  Eigen::VectorXd scale;
+  Eigen::MatrixXd eigenvectors;
+  Eigen::VectorXd eigenvalues;
+  Eigen::VectorXd projected_rhs;
+  double tolerance;
+};
+
+} // namespace grf
+
+#endif //GRF_RIDGEPATHSOLVER_H
@@ -15,6 +15,7 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
+#include <algorithm>
 #include <cmath>
 #include "prediction/SurvivalPredictionStrategy.h"
 
@@ -37,7 +38,7 @@ size_t SurvivalPredictionStrategy::prediction_length() const {
 }
 
 std::vector<double> SurvivalPredictionStrategy::predict(size_t prediction_sample,
-    const std::unordered_map<size_t, double>& weights_by_sample,
+    const std::vector<std::pair<size_t, double>>& weights_by_sample,
     const Data& train_data,
     const Data& data) const {
   // the event times will always range from 0, ..., num_failures
@@ -64,56 +65,92 @@ std::vector<double> SurvivalPredictionStrategy::predict(size_t prediction_sample
     return std::vector<double>();
   }
 
+  std::vector<size_t> times(num_failures + 1);
+  for (size_t time = 0; time <= num_failures; time++) {
+    times[time] = time;
+  }
+  return predict_survival_function(times, count_failure, count_censor, sum);
+}
+
+std::vector<double> SurvivalPredictionStrategy::predict_survival_function(
+    const std::vector<size_t>& times,
+    const std::vector<double>& count_failure,
+    const std::vector<double>& count_censor,
+    double sum) const {
   if (prediction_type == NELSON_AALEN) {
-    return predict_nelson_aalen(count_failure, count_censor, sum);
+    return predict_nelson_aalen(times, count_failure, count_censor, sum);
   } else if (prediction_type == KAPLAN_MEIER) {
-    return predict_kaplan_meier(count_failure, count_censor, sum);
+    return predict_kaplan_meier(times, count_failure, count_censor, sum);
   } else {
     throw std::runtime_error("SurvivalPredictionStrategy: unknown prediction type");
   }
 }
 
+// Both estimators only change at times with nonzero counts, so they are computed at those
+// times and carried forward over the times in between.
 std::vector<double> SurvivalPredictionStrategy::predict_kaplan_meier(
+  const std::vector<size_t>& times,
   const std::vector<double>& count_failure,
   const std::vector<double>& count_censor,
   double sum) const {
   // Kaplan–Meier estimator of the survival function S(t)
   double kaplan_meier = 1;
-  sum = sum - count_censor[0];
   std::vector<double> survival_function(num_failures);
 
-  for (size_t time = 1; time <= num_failures; time++) {
+  size_t filled = 0;
+  for (size_t i = 0; i < times.size(); i++) {
+   size_t time = times[i];
+   if (time == 0) {
+     sum = sum - count_censor[i];
+     continue;
+   }
+   std::fill(survival_function.begin() + filled, survival_function.begin() + time - 1, kaplan_meier);
+   filled = time - 1;
+
    if (sum > 0) {
-     kaplan_meier = kaplan_meier * (1 - count_failure[time] / sum);
+     kaplan_meier = kaplan_meier * (1 - count_failure[i] / sum);
      // If the estimate hits zero it will stay zero and we can break early.
      // This also prevents errors from accumulating which may yield some point estimates less than zero.
      if (kaplan_meier <= 0) {
-       break;
+       return survival_function;
      }
    }
    survival_function[time - 1] = kaplan_meier;
-   sum = sum - count_failure[time] - count_censor[time];
+   filled = time;
+   sum = sum - count_failure[i] - count_censor[i];
   }
+  std::fill(survival_function.begin() + filled, survival_function.end(), kaplan_meier);
 
   return survival_function;
 }
 
 std::vector<double> SurvivalPredictionStrategy::predict_nelson_aalen(
+  const std::vector<size_t>& times,
   const std::vector<double>& count_failure,
   const std::vector<double>& count_censor,
   double sum) const {
   // Nelson-Aalen estimator of the survival function S(t)
   double nelson_aalen = 0;
-  sum = sum - count_censor[0];
   std::vector<double> survival_function(num_failures);
 
-  for (size_t time = 1; time <= num_failures; time++) {
+  size_t filled = 0;
+  for (size_t i = 0; i < times.size(); i++) {
+    size_t time = times[i];
+    if (time == 0) {
+      sum = sum - count_censor[i];
+      continue;
+    }
+    std::fill(survival_function.begin() + filled, survival_function.begin() + time - 1, exp(nelson_aalen));
+    filled = time - 1;
+
     if (sum > 0) {
-      nelson_aalen = nelson_aalen - count_failure[time] / sum;
+      nelson_aalen = nelson_aalen - count_failure[i] / sum;
     }
     survival_function[time - 1] = exp(nelson_aalen);
-    sum = sum - count_failure[time] - count_censor[time];
+    filled = time;
+    sum = sum - count_failure[i] - count_censor[i];
   }
+  std::fill(survival_function.begin() + filled, survival_function.end(), exp(nelson_aalen));
 
    return survival_function;
 }
@@ -121,7 +158,7 @@ std::vector<double> SurvivalPredictionStrategy::predict_nelson_aalen(
 std::vector<double> SurvivalPredictionStrategy::compute_variance(
     size_t sample,
     const std::vector<std::vector<size_t>>& samples_by_tree,
-    const std::unordered_map<size_t, double>& weights_by_sampleID,
+    const std::vector<std::pair<size_t, double>>& weights_by_sampleID,
     const Data& train_data,
     const Data& data,
     size_t ci_group_size) const {
@@ -49,25 +49,41 @@ public:
   size_t prediction_length() const;
 
   std::vector<double> predict(size_t prediction_sample,
-    const std::unordered_map<size_t, double>& weights_by_sample,
+    const std::vector<std::pair<size_t, double>>& weights_by_sample,
     const Data& train_data,
     const Data& data) const;
 
   std::vector<double> compute_variance(
     size_t sample,
     const std::vector<std::vector<size_t>>& samples_by_tree,
-    const std::unordered_map<size_t, double>& weights_by_sampleID,
+    const std::vector<std::pair<size_t, double>>& weights_by_sampleID,
     const Data& train_data,
     const Data& data,
     size_t ci_group_size) const;
 
+  /**
+   * Computes the estimate of the survival function from weighted failure and censoring
+   * counts that are only nonzero at the given event times, in increasing order.
+   *
+   * times: the event times with nonzero counts
+   * count_failure, count_censor: the counts at each of these times
+   * sum: the total weight of all counts
+   */
+  std::vector<double> predict_survival_function(
+    const std::vector<size_t>& times,
+    const std::vector<double>& count_failure,
+    const std::vector<double>& count_censor,
+    double sum) const;
+
 private:
   std::vector<double> predict_kaplan_meier(
+    const std::vector<size_t>& times,
     const std::vector<double>& count_failure,
     const std::vector<double>& count_censor,
     double sum) const;
 
   std::vector<double> predict_nelson_aalen(
+    const std::vector<size_t>& times,
     const std::vector<double>& count_failure,
     const std::vector<double>& count_censor,
     double sum) const;
@@ -31,8 +31,7 @@ std::vector<Prediction> DefaultPredictionCollector::collect_predictions(
     const Forest& forest,
     const Data& train_data,
     const Data& data,
-    const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
-    const std::vector<std::vector<bool>>& valid_trees_by_sample,
+    const LeafAssignments& leaf_assignments,
     bool estimate_variance,
     bool estimate_error) const {
 
@@ -56,8 +55,7 @@ std::vector<Prediction> DefaultPredictionCollector::collect_predictions(
                                  std::ref(forest),
                                  std::ref(train_data),
                                  std::ref(data),
-                                 std::ref(leaf_nodes_by_tree),
-                                 std::ref(valid_trees_by_sample),
+                                 std::ref(leaf_assignments),
                                  estimate_variance,
                                  start_index,
                                  num_samples_batch));
@@ -77,44 +75,42 @@ std::vector<Prediction> DefaultPredictionCollector::collect_predictions_batch(
     const Forest& forest,
     const Data& train_data,
     const Data& data,
-    const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
-    const std::vector<std::vector<bool>>& valid_trees_by_sample,
+    const LeafAssignments& leaf_assignments,
     bool estimate_variance,
     size_t start,
     size_t num_samples) const {
   size_t num_trees = forest.get_trees().size();
   bool record_leaf_samples = estimate_variance;
+  const ValidTreesBySample& valid_trees_by_sample = leaf_assignments.get_valid_trees_by_sample();
 
   std::vector<Prediction> predictions;
   predictions.reserve(num_samples);
 
+  // The weight computer's accumulator, and the list of weights it fills in, are reused across samples.
+  SampleWeightComputer weight_computer(train_data.get_num_rows());
+  std::vector<std::pair<size_t, double>> weights_by_sample;
+
   for (size_t sample = start; sample < num_samples + start; ++sample) {
-    std::unordered_map<size_t, double> weights_by_sample = weight_computer.compute_weights(
-        sample, forest, leaf_nodes_by_tree, valid_trees_by_sample);
+    weight_computer.compute_weights(sample, forest, leaf_assignments, weights_by_sample);
     std::vector<std::vector<size_t>> samples_by_tree;
 
     // If this sample has no neighbors, then return placeholder predictions. Note
     // that this can only occur when honesty is enabled, and is expected to be rare.
     if (weights_by_sample.empty()) {
-      std::vector<double> nan(strategy->prediction_length(), NAN);
-      std::vector<double> empty;
-      predictions.emplace_back(nan, estimate_variance ? nan : empty, empty, empty);
+      predictions.push_back(empty_prediction(estimate_variance));
       continue;
     }
 
     if (record_leaf_samples) {
       samples_by_tree.resize(num_trees);
 
-      for (size_t tree_index = 0; tree_index < forest.get_trees().size(); ++tree_index) {
-        if (!valid_trees_by_sample[sample][tree_index]) {
-          continue;
-        }
-        const std::vector<size_t>& leaf_nodes = leaf_nodes_by_tree.at(tree_index);
-        size_t node = leaf_nodes.at(sample);
+      for (size_t tree_index = valid_trees_by_sample.next(sample, 0);
+           tree_index < num_trees;
+           tree_index = valid_trees_by_sample.next(sample, tree_index + 1)) {
+        size_t node = leaf_assignments.get_leaf_node(tree_index, sample);
 
         const std::unique_ptr<Tree>& tree = forest.get_trees()[tree_index];
-        const std::vector<std::vector<size_t>>& leaf_samples = tree->get_leaf_samples();
-        samples_by_tree.push_back(leaf_samples.at(node));
+        samples_by_tree.push_back(tree->get_leaf_samples(node).to_vector());
       }
     }
 
@@ -127,9 +123,7 @@ std::vector<Prediction> DefaultPredictionCollector::collect_predictions_batch(
     // This can occur if for example all case sample weights are zero,
     // and the prediction strategy opts to predict nothing.
     if (point_prediction.empty()) {
-      std::vector<double> nan(strategy->prediction_length(), NAN);
-      std::vector<double> empty;
-      predictions.emplace_back(nan, estimate_variance ? nan : empty, empty, empty);
+      predictions.push_back(empty_prediction(estimate_variance));
       continue;
     }
 
@@ -141,6 +135,95 @@ std::vector<Prediction> DefaultPredictionCollector::collect_predictions_batch(
   return predictions;
 }
 
+std::vector<Prediction> DefaultPredictionCollector::collect_predictions(const ForestWeights& kernel,
+                                                                        const Data& train_data,
+                                                                        const Data& data) const {
+  if (kernel.get_num_rows() != data.get_num_rows() || kernel.get_num_cols() != train_data.get_num_rows()) {
+    throw std::runtime_error("The forest kernel must have one row per test sample"
+       " and one column per training sample.");
+  }
+
+  size_t num_samples = data.get_num_rows();
+  std::vector<Prediction> predictions;
+  if (num_samples == 0) {
+    return predictions;
+  }
+
+  std::vector<uint> thread_ranges;
+  split_sequence(thread_ranges, 0, static_cast<uint>(num_samples - 1), num_threads);
+
+  std::vector<std::future<std::vector<Prediction>>> futures;
+  futures.reserve(thread_ranges.size());
+  predictions.reserve(num_samples);
+
+  for (uint i = 0; i < thread_ranges.size() - 1; ++i) {
+    size_t start_index = thread_ranges[i];
+    size_t num_samples_batch = thread_ranges[i + 1] - start_index;
+
+    futures.push_back(std::async(std::launch::async,
+                                 &DefaultPredictionCollector::collect_kernel_predictions_batch,
+                                 this,
+                                 std::ref(kernel),
+                                 std::ref(train_data),
+                                 std::ref(data),
+                                 start_index,
+                                 num_samples_batch));
+  }
+
+  for (auto& future : futures) {
+    std::vector<Prediction> thread_predictions = future.get();
+    predictions.insert(predictions.end(),
+                       std::make_move_iterator(thread_predictions.begin()),
+                       std::make_move_iterator(thread_predictions.end()));
+  }
+
+  return predictions;
+}
+
+std::vector<Prediction> DefaultPredictionCollector::collect_kernel_predictions_batch(
+    const ForestWeights& kernel,
+    const Data& train_data,
+    const Data& data,
+    size_t start,
+    size_t num_samples) const {
+  const std::vector<size_t>& row_offsets = kernel.get_row_offsets();
+  const std::vector<size_t>& columns = kernel.get_columns();
+  const std::vector<double>& values = kernel.get_values();
+
+  std::vector<Prediction> predictions;
+  predictions.reserve(num_samples);
+  std::vector<std::pair<size_t, double>> weights_by_sample;
+
+  for (size_t sample = start; sample < num_samples + start; ++sample) {
+    weights_by_sample.clear();
+    for (size_t index = row_offsets[sample]; index < row_offsets[sample + 1]; ++index) {
+      weights_by_sample.emplace_back(columns[index], values[index]);
+    }
+
+    if (weights_by_sample.empty()) {
+      predictions.push_back(empty_prediction(false));
+      continue;
+    }
+
+    std::vector<double> point_prediction = strategy->predict(sample, weights_by_sample, train_data, data);
+    if (point_prediction.empty()) {
+      predictions.push_back(empty_prediction(false));
+      continue;
+    }
+
+    validate_prediction(sample, point_prediction);
+    predictions.emplace_back(point_prediction);
+  }
+
+  return predictions;
+}
+
+Prediction DefaultPredictionCollector::empty_prediction(bool estimate_variance) const {
+  std::vector<double> nan(strategy->prediction_length(), NAN);
+  std::vector<double> empty;
+  return Prediction(nan, estimate_variance ? nan : empty, empty, empty);
+}
+
 void DefaultPredictionCollector::validate_prediction(size_t sample,
                                                      const Prediction& prediction) const {
   size_t prediction_length = strategy->prediction_length();
@@ -19,6 +19,7 @@
 #define GRF_DEFAULTPREDICTIONCOLLECTOR_H
 
 
+#include "analysis/ForestWeights.h"
 #include "forest/Forest.h"
 #include "prediction/collector/PredictionCollector.h"
 #include "prediction/collector/SampleWeightComputer.h"
@@ -38,25 +39,39 @@ public:
   std::vector<Prediction> collect_predictions(const Forest& forest,
                                               const Data& train_data,
                                               const Data& data,
-                                              const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
-                                              const std::vector<std::vector<bool>>& valid_trees_by_sample,
+                                              const LeafAssignments& leaf_assignments,
                                               bool estimate_variance,
                                               bool estimate_error) const;
 
+  /**
+   * Collect point predictions from a precomputed forest kernel, whose row i holds the
+   * weights of the training samples for test sample i. As the kernel no longer records
+   * which tree each neighbor came from, variance estimates are not available.
+   */
+  std::vector<Prediction> collect_predictions(const ForestWeights& kernel,
+                                              const Data& train_data,
+                                              const Data& data) const;
+
 private:
   std::vector<Prediction> collect_predictions_batch(const Forest& forest,
                                                     const Data& train_data,
                                                     const Data& data,
-                                                    const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
-                                                    const std::vector<std::vector<bool>>& valid_trees_by_sample,
+                                                    const LeafAssignments& leaf_assignments,
                                                     bool estimate_variance,
                                                     size_t start,
                                                     size_t num_samples) const;
 
+  std::vector<Prediction> collect_kernel_predictions_batch(const ForestWeights& kernel,
+                                                           const Data& train_data,
+                                                           const Data& data,
+                                                           size_t start,
+                                                           size_t num_samples) const;
+
+  Prediction empty_prediction(bool estimate_variance) const;
+
   void validate_prediction(size_t sample, const Prediction& prediction) const;
 
   std::unique_ptr<DefaultPredictionStrategy> strategy;
-  SampleWeightComputer weight_computer;
   uint num_threads;
 };
 
@@ -0,0 +1,131 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+
+#include "prediction/collector/LLCausalPredictionCollector.h"
+#include "commons/utility.h"
+
+namespace grf {
+
+LLCausalPredictionCollector::LLCausalPredictionCollector(std::vector<double> lambdas,
+                                                         bool weight_penalty,
+                                                         std::vector<size_t> linear_correction_variables,
+                                                         uint num_threads):
+    strategy(lambdas, weight_penalty, linear_correction_variables),
+    variance_collector(std::unique_ptr<DefaultPredictionStrategy>(
+        new LLCausalPredictionStrategy(lambdas, weight_penalty, linear_correction_variables)), num_threads),
+    linear_correction_variables(linear_correction_variables),
+    num_threads(num_threads) {}
+
+std::vector<Prediction> LLCausalPredictionCollector::collect_predictions(const Forest& forest,
+                                                                         const Data& train_data,
+                                                                         const Data& data,
+                                                                         const LeafAssignments& leaf_assignments,
+                                                                         bool estimate_variance,
+                                                                         bool estimate_error) const {
+  if (estimate_variance) {
+    return variance_collector.collect_predictions(forest, train_data, data, leaf_assignments,
+                                                  estimate_variance, estimate_error);
+  }
+
+  LeafMomentComputer moment_computer(linear_correction_variables, train_data, true);
+
+  size_t num_samples = data.get_num_rows();
+  std::vector<uint> thread_ranges;
+  split_sequence(thread_ranges, 0, static_cast<uint>(num_samples - 1), num_threads);
+
+  std::vector<std::future<std::vector<Prediction>>> futures;
+  futures.reserve(thread_ranges.size());
+
+  std::vector<Prediction> predictions;
+  predictions.reserve(num_samples);
+
+  for (uint i = 0; i < thread_ranges.size() - 1; ++i) {
+    size_t start_index = thread_ranges[i];
+    size_t num_samples_batch = thread_ranges[i + 1] - start_index;
+
+    futures.push_back(std::async(std::launch::async,
+                                 &LLCausalPredictionCollector::collect_predictions_batch,
+                                 this,
+                                 std::ref(forest),
+                                 std::ref(train_data),
+                                 std::ref(data),
+                                 std::ref(leaf_assignments),
+                                 std::ref(moment_computer),
+                                 start_index,
+                                 num_samples_batch));
+  }
+
+  for (auto& future : futures) {
+    std::vector<Prediction> thread_predictions = future.get();
+    predictions.insert(predictions.end(),
+                       std::make_move_iterator(thread_predictions.begin()),
+                       std::make_move_iterator(thread_predictions.end()));
+  }
+
+  return predictions;
+}
+
+std::vector<Prediction> LLCausalPredictionCollector::collect_predictions_batch(
+    const Forest& forest,
+    const Data& train_data,
+    const Data& data,
+    const LeafAssignments& leaf_assignments,
+    const LeafMomentComputer& moment_computer,
+    size_t start,
+    size_t num_samples) const {
+  size_t dimension = moment_computer.get_dimension();
+  size_t num_moments = moment_computer.get_num_moments();
+
+  std::vector<Prediction> predictions;
+  predictions.reserve(num_samples);
+
+  std::vector<double> moments;
+  std::vector<size_t> num_leaves;
+  Eigen::MatrixXd M_unpenalized(dimension, dimension);
+  Eigen::VectorXd weighted_outcomes(dimension);
+
+  // The thread's samples are split into as few blocks as memory allows, since the leaf
+  // moments of each tree are recomputed for every block.
+  size_t max_block_size = moment_computer.get_block_size();
+  for (size_t block_start = start; block_start < start + num_samples; block_start += max_block_size) {
+    size_t block_size = std::min(max_block_size, start + num_samples - block_start);
+    moment_computer.compute(block_start, block_size, forest, train_data, leaf_assignments, moments, num_leaves);
+
+    for (size_t i = 0; i < block_size; ++i) {
+      size_t sample = block_start + i;
+
+      // If this sample has no neighbors, then return placeholder predictions. Note
+      // that this can only occur when honesty is enabled, and is expected to be rare.
+      if (num_leaves[i] == 0) {
+        predictions.emplace_back(std::vector<double>(strategy.prediction_length(), NAN));
+        continue;
+      }
+
+      moment_computer.get_local_moments(moments.data() + i * num_moments, num_leaves[i], sample, data,
+                                        M_unpenalized, weighted_outcomes);
+      predictions.emplace_back(strategy.predict(M_unpenalized, weighted_outcomes));
+    }
+  }
+
+  return predictions;
+}
+
+} // namespace grf
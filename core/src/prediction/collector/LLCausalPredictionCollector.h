@@ -0,0 +1,73 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_LLCAUSALPREDICTIONCOLLECTOR_H
+#define GRF_LLCAUSALPREDICTIONCOLLECTOR_H
+
+#include <cstddef>
+#include <vector>
+
+#include "forest/Forest.h"
+#include "prediction/LLCausalPredictionStrategy.h"
+#include "prediction/collector/DefaultPredictionCollector.h"
+#include "prediction/collector/LeafMomentComputer.h"
+#include "prediction/collector/PredictionCollector.h"
+
+namespace grf {
+
+/**
+ * Collects local linear causal predictions from per-leaf sufficient statistics.
+ *
+ * As in LocalLinearPredictionCollector, the weighted moments of each test sample's local
+ * design are assembled from the moments of its leaves, here with the treatment and its
+ * interactions with the linear correction variables added to the basis. This takes
+ * O(trees * p^2) per sample rather than O(neighbors * p^2).
+ *
+ * Variance estimates are delegated to the weights-based LLCausalPredictionStrategy.
+ */
+class LLCausalPredictionCollector final: public PredictionCollector {
+public:
+  LLCausalPredictionCollector(std::vector<double> lambdas,
+                              bool weight_penalty,
+                              std::vector<size_t> linear_correction_variables,
+                              uint num_threads);
+
+  std::vector<Prediction> collect_predictions(const Forest& forest,
+                                              const Data& train_data,
+                                              const Data& data,
+                                              const LeafAssignments& leaf_assignments,
+                                              bool estimate_variance,
+                                              bool estimate_error) const;
+
+private:
+  std::vector<Prediction> collect_predictions_batch(const Forest& forest,
+                                                    const Data& train_data,
+                                                    const Data& data,
+                                                    const LeafAssignments& leaf_assignments,
+                                                    const LeafMomentComputer& moment_computer,
+                                                    size_t start,
+                                                    size_t num_samples) const;
+
+  LLCausalPredictionStrategy strategy;
+  DefaultPredictionCollector variance_collector;
+  std::vector<size_t> linear_correction_variables;
+  uint num_threads;
+};
+
+} // namespace grf
+
+#endif //GRF_LLCAUSALPREDICTIONCOLLECTOR_H
@@ -0,0 +1,47 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <utility>
+
+#include "prediction/collector/LeafAssignments.h"
+
+namespace grf {
+
+LeafAssignments::LeafAssignments(std::vector<std::vector<uint32_t>>&& leaf_nodes_by_tree,
+                                 ValidTreesBySample&& valid_trees_by_sample,
+                                 bool oob_prediction):
+    leaf_nodes_by_tree(std::move(leaf_nodes_by_tree)),
+    valid_trees_by_sample(std::move(valid_trees_by_sample)),
+    oob_prediction(oob_prediction) {}
+
+const ValidTreesBySample& LeafAssignments::get_valid_trees_by_sample() const {
+  return valid_trees_by_sample;
+}
+
+size_t LeafAssignments::get_num_trees() const {
+  return leaf_nodes_by_tree.size();
+}
+
+size_t LeafAssignments::get_num_samples() const {
+  return leaf_nodes_by_tree.empty() ? 0 : leaf_nodes_by_tree[0].size();
+}
+
+bool LeafAssignments::is_oob_prediction() const {
+  return oob_prediction;
+}
+
+} // namespace grf
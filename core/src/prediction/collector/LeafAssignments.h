@@ -0,0 +1,70 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_LEAFASSIGNMENTS_H
+#define GRF_LEAFASSIGNMENTS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "prediction/collector/ValidTreesBySample.h"
+
+namespace grf {
+
+/**
+ * The leaf that each sample falls into in each tree of a forest, together with the
+ * trees that are valid for each sample.
+ *
+ * Leaf IDs are stored as 32-bit integers, one row per tree, so that the traversal
+ * can be computed once for a forest and a set of samples and then reused by any
+ * prediction collector, across strategies and calls. Entries for trees that are not
+ * valid for a sample are unspecified.
+ */
+class LeafAssignments {
+public:
+  LeafAssignments(std::vector<std::vector<uint32_t>>&& leaf_nodes_by_tree,
+                  ValidTreesBySample&& valid_trees_by_sample,
+                  bool oob_prediction);
+
+  size_t get_leaf_node(size_t tree, size_t sample) const;
+
+  const ValidTreesBySample& get_valid_trees_by_sample() const;
+
+  size_t get_num_trees() const;
+
+  size_t get_num_samples() const;
+
+  /**
+   * Whether only the trees for which each sample was out-of-bag are valid.
+   */
+  bool is_oob_prediction() const;
+
+private:
+  std::vector<std::vector<uint32_t>> leaf_nodes_by_tree;
+  ValidTreesBySample valid_trees_by_sample;
+  bool oob_prediction;
+};
+
+// inline the accessor used in the prediction hot loops
+inline size_t LeafAssignments::get_leaf_node(size_t tree, size_t sample) const {
+  return leaf_nodes_by_tree[tree][sample];
+}
+
+} // namespace grf
+
+#endif //GRF_LEAFASSIGNMENTS_H
@@ -0,0 +1,200 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "prediction/collector/LeafMomentComputer.h"
+
+namespace grf {
+
+const size_t LeafMomentComputer::MAX_BLOCK_MOMENTS;
+
+LeafMomentComputer::LeafMomentComputer(const std::vector<size_t>& variables,
+                                       const Data& train_data):
+    LeafMomentComputer(variables, train_data, false) {}
+
+LeafMomentComputer::LeafMomentComputer(const std::vector<size_t>& variables,
+                                       const Data& train_data,
+                                       bool interact_treatment):
+    variables(variables),
+    interact_treatment(interact_treatment),
+    dimension(interact_treatment ? 2 * variables.size() + 2 : variables.size() + 1) {
+  // Center each variable at its mean over the non-missing training values.
+  for (size_t var : variables) {
+    double sum = 0.0;
+    size_t count = 0;
+    for (size_t sample = 0; sample < train_data.get_num_rows(); ++sample) {
+      double value = train_data.get(sample, var);
+      if (!std::isnan(value)) {
+        sum += value;
+        count++;
+      }
+    }
+    centers.push_back(count > 0 ? sum / count : 0.0);
+  }
+}
+
+size_t LeafMomentComputer::get_dimension() const {
+  return dimension;
+}
+
+size_t LeafMomentComputer::get_num_moments() const {
+  return dimension * dimension + dimension;
+}
+
+size_t LeafMomentComputer::get_treatment_index() const {
+  return variables.size() + 1;
+}
+
+size_t LeafMomentComputer::get_block_size() const {
+  return std::max(MAX_BLOCK_MOMENTS / get_num_moments(), static_cast<size_t>(1));
+}
+
+void LeafMomentComputer::compute(size_t start,
+                                 size_t num_samples,
+                                 const Forest& forest,
+                                 const Data& train_data,
+                                 const LeafAssignments& leaf_assignments,
+                                 std::vector<double>& moments,
+                                 std::vector<size_t>& num_leaves) const {
+  size_t num_moments = get_num_moments();
+  moments.assign(num_samples * num_moments, 0.0);
+  num_leaves.assign(num_samples, 0);
+
+  const ValidTreesBySample& valid_trees_by_sample = leaf_assignments.get_valid_trees_by_sample();
+  size_t num_trees = forest.get_trees().size();
+
+  // Within a tree, the moments of each leaf reached by the block are computed once, into
+  // the slot recorded for the leaf's node.
+  std::vector<size_t> slot_by_node;
+  std::vector<double> leaf_moments;
+  std::vector<double> basis(dimension);
+
+  for (size_t tree_index = 0; tree_index < num_trees; ++tree_index) {
+    const std::unique_ptr<Tree>& tree = forest.get_trees()[tree_index];
+    if (!tree->has_leaf_samples()) {
+      throw std::runtime_error("Local linear predictions cannot be computed for a forest trained without "
+                               "keeping its leaf samples.");
+    }
+    slot_by_node.assign(tree->get_num_nodes(), 0);
+    size_t num_slots = 0;
+
+    for (size_t i = 0; i < num_samples; ++i) {
+      size_t sample = start + i;
+      if (!valid_trees_by_sample.is_valid(sample, tree_index)) {
+        continue;
+      }
+
+      size_t node = leaf_assignments.get_leaf_node(tree_index, sample);
+      SampleSpan samples = tree->get_leaf_samples(node);
+      if (samples.empty()) {
+        continue;
+      }
+
+      // Slots are stored one above their index, so that zero means not yet computed.
+      if (slot_by_node[node] == 0) {
+        leaf_moments.resize((num_slots + 1) * num_moments);
+        compute_leaf_moments(samples, train_data, basis, leaf_moments.data() + num_slots * num_moments);
+        slot_by_node[node] = ++num_slots;
+      }
+
+      const double* leaf = leaf_moments.data() + (slot_by_node[node] - 1) * num_moments;
+      double* sample_moments = moments.data() + i * num_moments;
+      for (size_t k = 0; k < num_moments; ++k) {
+        sample_moments[k] += leaf[k];
+      }
+      num_leaves[i]++;
+    }
+  }
+}
+
+void LeafMomentComputer::get_local_moments(const double* sample_moments,
+                                           size_t num_leaves,
+                                           size_t sample,
+                                           const Data& data,
+                                           Eigen::MatrixXd& M_unpenalized,
+                                           Eigen::VectorXd& weighted_outcomes) const {
+  // The change of basis that moves the design's center to the test sample: each centered
+  // variable is shifted by the test sample's centered value, times the intercept for the
+  // variable itself and times the treatment for its interaction.
+  size_t num_variables = variables.size();
+  size_t treatment_index = get_treatment_index();
+  Eigen::MatrixXd change_of_basis = Eigen::MatrixXd::Identity(dimension, dimension);
+  for (size_t j = 0; j < num_variables; ++j) {
+    double shift = centers[j] - data.get(sample, variables[j]);
+    change_of_basis(j + 1, 0) = shift;
+    if (interact_treatment) {
+      change_of_basis(treatment_index + j + 1, treatment_index) = shift;
+    }
+  }
+
+  Eigen::Map<const Eigen::MatrixXd> gram(sample_moments, dimension, dimension);
+  Eigen::Map<const Eigen::VectorXd> outcomes(sample_moments + dimension * dimension, dimension);
+
+  // Each leaf's moments carry a total weight of one, so averaging over the leaves
+  // normalizes the forest weights to sum to one.
+  double normalization = 1.0 / num_leaves;
+  M_unpenalized.noalias() = normalization * change_of_basis * gram * change_of_basis.transpose();
+  weighted_outcomes.noalias() = normalization * change_of_basis * outcomes;
+}
+
+void LeafMomentComputer::compute_leaf_moments(const SampleSpan& samples,
+                                              const Data& train_data,
+                                              std::vector<double>& basis,
+                                              double* leaf_moments) const {
+  double* gram = leaf_moments;
+  double* weighted_outcomes = leaf_moments + dimension * dimension;
+  std::fill(leaf_moments, leaf_moments + get_num_moments(), 0.0);
+
+  size_t num_variables = variables.size();
+  size_t treatment_index = get_treatment_index();
+  basis[0] = 1.0;
+  for (size_t sample : samples) {
+    for (size_t j = 0; j < num_variables; ++j) {
+      basis[j + 1] = train_data.get(sample, variables[j]) - centers[j];
+    }
+    if (interact_treatment) {
+      double treatment = train_data.get_treatment(sample);
+      basis[treatment_index] = treatment;
+      for (size_t j = 0; j < num_variables; ++j) {
+        basis[treatment_index + j + 1] = basis[j + 1] * treatment;
+      }
+    }
+    double outcome = train_data.get_outcome(sample);
+
+    // Only the lower triangle is accumulated, and then mirrored.
+    for (size_t col = 0; col < dimension; ++col) {
+      for (size_t row = col; row < dimension; ++row) {
+        gram[col * dimension + row] += basis[row] * basis[col];
+      }
+      weighted_outcomes[col] += basis[col] * outcome;
+    }
+  }
+
+  double leaf_weight = 1.0 / samples.size();
+  for (size_t col = 0; col < dimension; ++col) {
+    for (size_t row = col; row < dimension; ++row) {
+      gram[col * dimension + row] *= leaf_weight;
+      gram[row * dimension + col] = gram[col * dimension + row];
+    }
+    weighted_outcomes[col] *= leaf_weight;
+  }
+}
+
+} // namespace grf
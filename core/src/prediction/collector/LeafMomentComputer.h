@@ -0,0 +1,129 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_LEAFMOMENTCOMPUTER_H
+#define GRF_LEAFMOMENTCOMPUTER_H
+
+#include <cstddef>
+#include <vector>
+
+#include "Eigen/Dense"
+#include "commons/Data.h"
+#include "forest/Forest.h"
+#include "prediction/collector/LeafAssignments.h"
+
+namespace grf {
+
+/**
+ * Computes forest-weighted moments of a local linear design for blocks of test samples,
+ * from sufficient statistics of the leaves they fall into.
+ *
+ * Each training sample i has a basis vector u_i made of an intercept and its linear
+ * correction variables, centered at the training means for numerical stability. When the
+ * treatment is interacted, the basis continues with the treatment W_i and the products of
+ * the centered variables with W_i, as in the local linear causal design. A leaf with L
+ * samples is summarized by its moments sum(u_i u_i') / L and sum(u_i Y_i) / L, and the
+ * forest-weighted moments of a test sample are the average of these over its leaves.
+ * Moving the design's center to the test sample is then a linear change of basis (see
+ * get_local_moments), so the moments never need to be formed over individual neighbors.
+ *
+ * Blocks are processed tree by tree, and the moments of a leaf are computed only once per
+ * block, no matter how many of the block's samples fall into it. Only one tree's leaf
+ * moments are cached at a time, while the moments of every sample in the block are kept
+ * until all trees are done, so callers should make blocks as large as get_block_size
+ * allows: typically a thread's whole range of test samples fits in one block, and each
+ * leaf's moments are then computed once per thread.
+ */
+class LeafMomentComputer {
+public:
+  LeafMomentComputer(const std::vector<size_t>& variables,
+                     const Data& train_data);
+
+  LeafMomentComputer(const std::vector<size_t>& variables,
+                     const Data& train_data,
+                     bool interact_treatment);
+
+  /**
+   * The size of the basis, and so the number of rows and columns of the Gram matrix.
+   */
+  size_t get_dimension() const;
+
+  /**
+   * The number of values in the moments of one sample: the Gram matrix (column-major)
+   * followed by the weighted outcomes.
+   */
+  size_t get_num_moments() const;
+
+  /**
+   * The index of the treatment in the basis, which only includes it when the treatment
+   * is interacted.
+   */
+  size_t get_treatment_index() const;
+
+  /**
+   * The largest number of test samples to pass to compute at once, so that their moments
+   * take at most MAX_BLOCK_MOMENTS values.
+   */
+  size_t get_block_size() const;
+
+  /**
+   * The maximum number of sample moments held by one call to compute (32 MB). This
+   * trades memory for fewer recomputations of leaf moments across blocks.
+   */
+  static const size_t MAX_BLOCK_MOMENTS = 1 << 22;
+
+  /**
+   * Fills moments with the forest-weighted moments of the test samples start, ...,
+   * start + num_samples - 1, one block of get_num_moments() values per sample, and
+   * num_leaves with the number of non-empty leaves each sample fell into. Samples that
+   * fell into no non-empty leaf get zero moments.
+   */
+  void compute(size_t start,
+               size_t num_samples,
+               const Forest& forest,
+               const Data& train_data,
+               const LeafAssignments& leaf_assignments,
+               std::vector<double>& moments,
+               std::vector<size_t>& num_leaves) const;
+
+  /**
+   * Turns the moments of one sample, as filled in by compute, into the weighted Gram
+   * matrix X'WX and weighted outcomes X'WY of the local design centered at the test
+   * sample, with forest weights summing to one.
+   */
+  void get_local_moments(const double* sample_moments,
+                         size_t num_leaves,
+                         size_t sample,
+                         const Data& data,
+                         Eigen::MatrixXd& M_unpenalized,
+                         Eigen::VectorXd& weighted_outcomes) const;
+
+private:
+  void compute_leaf_moments(const SampleSpan& samples,
+                            const Data& train_data,
+                            std::vector<double>& basis,
+                            double* leaf_moments) const;
+
+  std::vector<size_t> variables;
+  std::vector<double> centers;
+  bool interact_treatment;
+  size_t dimension;
+};
+
+} // namespace grf
+
+#endif //GRF_LEAFMOMENTCOMPUTER_H
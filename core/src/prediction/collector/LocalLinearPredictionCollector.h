@@ -0,0 +1,75 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_LOCALLINEARPREDICTIONCOLLECTOR_H
+#define GRF_LOCALLINEARPREDICTIONCOLLECTOR_H
+
+#include <cstddef>
+#include <vector>
+
+#include "forest/Forest.h"
+#include "prediction/LocalLinearPredictionStrategy.h"
+#include "prediction/collector/DefaultPredictionCollector.h"
+#include "prediction/collector/LeafMomentComputer.h"
+#include "prediction/collector/PredictionCollector.h"
+
+namespace grf {
+
+/**
+ * Collects local linear regression predictions from per-leaf sufficient statistics.
+ *
+ * The weighted moments X'WX and X'WY of each test sample's local design are assembled
+ * from the moments of its leaves by LeafMomentComputer, in O(trees * p^2) per sample, and
+ * then passed to LocalLinearPredictionStrategy for the ridge regularization path. The
+ * linear correction variables are only known at prediction time, so leaf moments are
+ * computed then, rather than during training.
+ *
+ * Variance estimates need the residual of every neighbor, so those predictions are
+ * delegated to the weights-based LocalLinearPredictionStrategy.
+ */
+class LocalLinearPredictionCollector final: public PredictionCollector {
+public:
+  LocalLinearPredictionCollector(std::vector<double> lambdas,
+                                 bool weight_penalty,
+                                 std::vector<size_t> linear_correction_variables,
+                                 uint num_threads);
+
+  std::vector<Prediction> collect_predictions(const Forest& forest,
+                                              const Data& train_data,
+                                              const Data& data,
+                                              const LeafAssignments& leaf_assignments,
+                                              bool estimate_variance,
+                                              bool estimate_error) const;
+
+private:
+  std::vector<Prediction> collect_predictions_batch(const Forest& forest,
+                                                    const Data& train_data,
+                                                    const Data& data,
+                                                    const LeafAssignments& leaf_assignments,
+                                                    const LeafMomentComputer& moment_computer,
+                                                    size_t start,
+                                                    size_t num_samples) const;
+
+  LocalLinearPredictionStrategy strategy;
+  DefaultPredictionCollector variance_collector;
+  std::vector<size_t> linear_correction_variables;
+  uint num_threads;
+};
+
+} // namespace grf
+
+#endif //GRF_LOCALLINEARPREDICTIONCOLLECTOR_H
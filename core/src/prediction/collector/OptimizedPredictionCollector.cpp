@@ -15,7 +15,9 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
+#include <algorithm>
 #include <future>
+#include <numeric>
 #include <stdexcept>
 
 #include "prediction/collector/OptimizedPredictionCollector.h"
@@ -23,14 +25,16 @@
 
 namespace grf {
 
+const size_t OptimizedPredictionCollector::SAMPLE_BLOCK_SIZE;
+const size_t OptimizedPredictionCollector::OOB_BLOCK_SIZE;
+
 OptimizedPredictionCollector::OptimizedPredictionCollector(std::unique_ptr<OptimizedPredictionStrategy> strategy, uint num_threads):
     strategy(std::move(strategy)), num_threads(num_threads) {}
 
 std::vector<Prediction> OptimizedPredictionCollector::collect_predictions(const Forest& forest,
                                                                           const Data& train_data,
                                                                           const Data& data,
-                                                                          const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
-                                                                          const std::vector<std::vector<bool>>& valid_trees_by_sample,
+                                                                          const LeafAssignments& leaf_assignments,
                                                                           bool estimate_variance,
                                                                           bool estimate_error) const {
   size_t num_samples = data.get_num_rows();
@@ -53,8 +57,7 @@ std::vector<Prediction> OptimizedPredictionCollector::collect_predictions(const
                                  std::ref(forest),
                                  std::ref(train_data),
                                  std::ref(data),
-                                 std::ref(leaf_nodes_by_tree),
-                                 std::ref(valid_trees_by_sample),
+                                 std::ref(leaf_assignments),
                                  estimate_variance,
                                  estimate_error,
                                  start_index,
@@ -74,34 +77,36 @@ std::vector<Prediction> OptimizedPredictionCollector::collect_predictions(const
 std::vector<Prediction> OptimizedPredictionCollector::collect_predictions_batch(const Forest& forest,
                                                                                 const Data& train_data,
                                                                                 const Data& data,
-                                                                                const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
-                                                                                const std::vector<std::vector<bool>>& valid_trees_by_sample,
+                                                                                const LeafAssignments& leaf_assignments,
                                                                                 bool estimate_variance,
                                                                                 bool estimate_error,
                                                                                 size_t start,
                                                                                 size_t num_samples) const {
   size_t num_trees = forest.get_trees().size();
   bool record_leaf_values = estimate_variance || estimate_error;
+  const ValidTreesBySample& valid_trees_by_sample = leaf_assignments.get_valid_trees_by_sample();
 
   std::vector<Prediction> predictions;
   predictions.reserve(num_samples);
 
+  // A view over each tree's leaf values for the current sample, reused across samples.
+  PredictionValuesView leaf_values(record_leaf_values ? num_trees : 0, strategy->prediction_value_length());
+
   for (size_t sample = start; sample < num_samples + start; ++sample) {
     std::vector<double> average_value;
-    std::vector<std::vector<double>> leaf_values;
-    if (record_leaf_values) {
-      leaf_values.resize(num_trees);
-    }
 
     // Create a list of weighted neighbors for this sample.
     uint num_leaves = 0;
-    for (size_t tree_index = 0; tree_index < forest.get_trees().size(); ++tree_index) {
-      if (!valid_trees_by_sample[sample][tree_index]) {
-        continue;
+    if (record_leaf_values) {
+      for (size_t tree_index = 0; tree_index < num_trees; ++tree_index) {
+        leaf_values.set_row(tree_index, nullptr);
       }
+    }
+    for (size_t tree_index = valid_trees_by_sample.next(sample, 0);
+         tree_index < num_trees;
+         tree_index = valid_trees_by_sample.next(sample, tree_index + 1)) {
 
-      const std::vector<size_t>& leaf_nodes = leaf_nodes_by_tree.at(tree_index);
-      size_t node = leaf_nodes.at(sample);
+      size_t node = leaf_assignments.get_leaf_node(tree_index, sample);
 
       const std::unique_ptr<Tree>& tree = forest.get_trees()[tree_index];
       const PredictionValues& prediction_values = tree->get_prediction_values();
@@ -109,48 +114,256 @@ std::vector<Prediction> OptimizedPredictionCollector::collect_predictions_batch(
       if (!prediction_values.empty(node)) {
         num_leaves++;
         add_prediction_values(node, prediction_values, average_value);
+      }
+      if (record_leaf_values) {
+        leaf_values.set_row(tree_index, prediction_values.get_row(node));
+      }
+    }
+
+    predictions.push_back(finalize_prediction(sample, num_leaves, average_value, leaf_values, forest, data,
+                                              estimate_variance, estimate_error));
+  }
+  return predictions;
+}
+
+std::vector<Prediction> OptimizedPredictionCollector::collect_predictions(const Forest& forest,
+                                                                          const Data& data,
+                                                                          bool estimate_variance,
+                                                                          bool oob_prediction) const {
+  size_t num_samples = data.get_num_rows();
+  std::vector<uint> thread_ranges;
+  split_sequence(thread_ranges, 0, static_cast<uint>(num_samples - 1), num_threads);
+
+  std::vector<std::future<std::vector<Prediction>>> futures;
+  futures.reserve(thread_ranges.size());
+
+  std::vector<Prediction> predictions;
+  predictions.reserve(num_samples);
+
+  // Each thread owns the accumulators of its range of samples, so that every sample's
+  // leaf values are summed in tree order by either path.
+  auto collect_batch = oob_prediction
+      ? &OptimizedPredictionCollector::collect_oob_predictions_batch
+      : &OptimizedPredictionCollector::collect_fused_predictions_batch;
+
+  for (uint i = 0; i < thread_ranges.size() - 1; ++i) {
+    size_t start_index = thread_ranges[i];
+    size_t num_samples_batch = thread_ranges[i + 1] - start_index;
+
+    futures.push_back(std::async(std::launch::async,
+                                 collect_batch,
+                                 this,
+                                 std::ref(forest),
+                                 std::ref(data),
+                                 estimate_variance,
+                                 oob_prediction,
+                                 start_index,
+                                 num_samples_batch));
+  }
+
+  for (auto& future : futures) {
+    std::vector<Prediction> thread_predictions = future.get();
+    predictions.insert(predictions.end(),
+                       std::make_move_iterator(thread_predictions.begin()),
+                       std::make_move_iterator(thread_predictions.end()));
+  }
+
+  return predictions;
+}
+
+std::vector<Prediction> OptimizedPredictionCollector::collect_fused_predictions_batch(const Forest& forest,
+                                                                                      const Data& data,
+                                                                                      bool estimate_variance,
+                                                                                      bool oob_prediction,
+                                                                                      size_t start,
+                                                                                      size_t num_samples) const {
+  const std::vector<std::unique_ptr<Tree>>& trees = forest.get_trees();
+  size_t num_trees = trees.size();
+  size_t num_cols = data.get_num_cols();
+  size_t num_types = strategy->prediction_value_length();
+  bool estimate_error = oob_prediction;
+  bool record_leaf_values = estimate_variance || estimate_error;
+
+  std::vector<Prediction> predictions;
+  predictions.reserve(num_samples);
+
+  // Every tree may split on any variable, so the tile holds all columns.
+  std::vector<size_t> column_by_var(num_cols);
+  std::iota(column_by_var.begin(), column_by_var.end(), 0);
+
+  // Per-block buffers, reused across blocks.
+  std::vector<double> tile;
+  std::vector<size_t> tile_samples;
+  std::vector<size_t> leaf_nodes;
+  std::vector<std::vector<double>> sums(SAMPLE_BLOCK_SIZE);
+  std::vector<uint> num_leaves(SAMPLE_BLOCK_SIZE);
+  std::vector<const double*> rows(record_leaf_values ? SAMPLE_BLOCK_SIZE * num_trees : 0);
+  PredictionValuesView leaf_values(record_leaf_values ? num_trees : 0, num_types);
+
+  for (size_t block_start = start; block_start < start + num_samples; block_start += SAMPLE_BLOCK_SIZE) {
+    size_t block_size = std::min(SAMPLE_BLOCK_SIZE, start + num_samples - block_start);
+
+    tile.resize(block_size * num_cols);
+    for (size_t col = 0; col < num_cols; ++col) {
+      for (size_t s = 0; s < block_size; ++s) {
+        tile[s * num_cols + col] = data.get(block_start + s, col);
+      }
+    }
+    tile_samples.resize(block_size);
+    std::iota(tile_samples.begin(), tile_samples.end(), 0);
+    for (size_t s = 0; s < block_size; ++s) {
+      sums[s].clear();
+      num_leaves[s] = 0;
+    }
+    std::fill(rows.begin(), rows.end(), nullptr);
+
+    for (size_t tree_index = 0; tree_index < num_trees; ++tree_index) {
+      const std::unique_ptr<Tree>& tree = trees[tree_index];
+
+      tree->find_leaf_nodes(tile.data(), num_cols, column_by_var, tile_samples, leaf_nodes);
+
+      const PredictionValues& prediction_values = tree->get_prediction_values();
+      for (size_t j = 0; j < tile_samples.size(); ++j) {
+        size_t s = tile_samples[j];
+        size_t node = leaf_nodes[j];
+        if (!prediction_values.empty(node)) {
+          num_leaves[s]++;
+          add_prediction_values(node, prediction_values, sums[s]);
+        }
         if (record_leaf_values) {
-          leaf_values[tree_index] = prediction_values.get_values(node);
+          rows[s * num_trees + tree_index] = prediction_values.get_row(node);
         }
       }
     }
 
-    // If this sample has no neighbors, then return placeholder predictions. Note
-    // that this can only occur when honesty is enabled, and is expected to be rare.
-    if (num_leaves == 0) {
-      std::vector<double> nan(strategy->prediction_length(), NAN);
-      std::vector<double> nan_error(1, NAN);
-      predictions.emplace_back(nan, estimate_variance ? nan : std::vector<double>(), nan_error, nan_error);
-      continue;
+    for (size_t s = 0; s < block_size; ++s) {
+      if (record_leaf_values) {
+        for (size_t tree_index = 0; tree_index < num_trees; ++tree_index) {
+          leaf_values.set_row(tree_index, rows[s * num_trees + tree_index]);
+        }
+      }
+      predictions.push_back(finalize_prediction(block_start + s, num_leaves[s], sums[s], leaf_values, forest, data,
+                                                estimate_variance, estimate_error));
     }
+  }
+  return predictions;
+}
+
+std::vector<Prediction> OptimizedPredictionCollector::collect_oob_predictions_batch(const Forest& forest,
+                                                                                    const Data& data,
+                                                                                    bool estimate_variance,
+                                                                                    bool oob_prediction,
+                                                                                    size_t start,
+                                                                                    size_t num_samples) const {
+  const std::vector<std::unique_ptr<Tree>>& trees = forest.get_trees();
+  size_t num_trees = trees.size();
+  size_t num_types = strategy->prediction_value_length();
+  bool estimate_error = oob_prediction;
+  bool record_leaf_values = estimate_variance || estimate_error;
+
+  std::vector<Prediction> predictions;
+  predictions.reserve(num_samples);
 
-    normalize_prediction_values(num_leaves, average_value);
-    std::vector<double> point_prediction = strategy->predict(average_value);
+  // Per-block accumulators, reused across blocks.
+  std::vector<double> sums(OOB_BLOCK_SIZE * num_types);
+  std::vector<uint> num_leaves(OOB_BLOCK_SIZE);
+  std::vector<const double*> rows(record_leaf_values ? OOB_BLOCK_SIZE * num_trees : 0);
+  PredictionValuesView leaf_values(record_leaf_values ? num_trees : 0, num_types);
 
-    PredictionValues prediction_values(leaf_values, strategy->prediction_value_length());
-    std::vector<double> variance = estimate_variance
-        ? strategy->compute_variance(average_value, prediction_values, forest.get_ci_group_size())
-        : std::vector<double>();
+  for (size_t block_start = start; block_start < start + num_samples; block_start += OOB_BLOCK_SIZE) {
+    size_t block_end = std::min(block_start + OOB_BLOCK_SIZE, start + num_samples);
+    std::fill(sums.begin(), sums.end(), 0.0);
+    std::fill(num_leaves.begin(), num_leaves.end(), 0);
+    std::fill(rows.begin(), rows.end(), nullptr);
 
-    std::vector<double> mse;
-    std::vector<double> mce;
+    for (size_t tree_index = 0; tree_index < num_trees; ++tree_index) {
+      const std::unique_ptr<Tree>& tree = trees[tree_index];
+      const PredictionValues& prediction_values = tree->get_prediction_values();
 
-    if (estimate_error) {
-      std::vector<std::pair<double, double>> error = strategy->compute_error(
-              sample, average_value, prediction_values, data);
+      // Walk the block's samples alongside the tree's sorted drawn samples, visiting
+      // only the ones left out of bag.
+      SampleSpan drawn_samples = tree->get_drawn_samples();
+      size_t cursor = drawn_samples.lower_bound(block_start);
+      for (size_t sample = block_start; sample < block_end; ++sample) {
+        if (cursor < drawn_samples.size() && drawn_samples[cursor] == sample) {
+          cursor++;
+          continue;
+        }
 
-      mse.push_back(error[0].first);
-      mce.push_back(error[0].second);
+        size_t s = sample - block_start;
+        size_t node = tree->find_leaf_node(data, sample);
+        if (!prediction_values.empty(node)) {
+          num_leaves[s]++;
+          const double* leaf_value = prediction_values.get_row(node);
+          double* sum = sums.data() + s * num_types;
+          for (size_t type = 0; type < prediction_values.get_num_types(); ++type) {
+            sum[type] += leaf_value[type];
+          }
+        }
+        if (record_leaf_values) {
+          rows[s * num_trees + tree_index] = prediction_values.get_row(node);
+        }
+      }
     }
 
-    Prediction prediction(point_prediction, variance, mse, mce);
-
-    validate_prediction(sample, prediction);
-    predictions.push_back(prediction);
+    for (size_t sample = block_start; sample < block_end; ++sample) {
+      size_t s = sample - block_start;
+      if (record_leaf_values) {
+        for (size_t tree_index = 0; tree_index < num_trees; ++tree_index) {
+          leaf_values.set_row(tree_index, rows[s * num_trees + tree_index]);
+        }
+      }
+      std::vector<double> average_value;
+      if (num_leaves[s] > 0) {
+        average_value.assign(sums.begin() + s * num_types, sums.begin() + (s + 1) * num_types);
+      }
+      predictions.push_back(finalize_prediction(sample, num_leaves[s], average_value, leaf_values, forest, data,
+                                                estimate_variance, estimate_error));
+    }
   }
   return predictions;
 }
 
+Prediction OptimizedPredictionCollector::finalize_prediction(size_t sample,
+                                                             size_t num_leaves,
+                                                             std::vector<double>& average_value,
+                                                             const PredictionValuesView& leaf_values,
+                                                             const Forest& forest,
+                                                             const Data& data,
+                                                             bool estimate_variance,
+                                                             bool estimate_error) const {
+  // If this sample has no neighbors, then return placeholder predictions. Note
+  // that this can only occur when honesty is enabled, and is expected to be rare.
+  if (num_leaves == 0) {
+    std::vector<double> nan(strategy->prediction_length(), NAN);
+    std::vector<double> nan_error(1, NAN);
+    return Prediction(nan, estimate_variance ? nan : std::vector<double>(), nan_error, nan_error);
+  }
+
+  normalize_prediction_values(num_leaves, average_value);
+  std::vector<double> point_prediction = strategy->predict(average_value);
+
+  std::vector<double> variance = estimate_variance
+      ? strategy->compute_variance(average_value, leaf_values, forest.get_ci_group_size())
+      : std::vector<double>();
+
+  std::vector<double> mse;
+  std::vector<double> mce;
+
+  if (estimate_error) {
+    std::vector<std::pair<double, double>> error = strategy->compute_error(
+            sample, average_value, leaf_values, data);
+
+    mse.push_back(error[0].first);
+    mce.push_back(error[0].second);
+  }
+
+  Prediction prediction(point_prediction, variance, mse, mce);
+
+  validate_prediction(sample, prediction);
+  return prediction;
+}
+
 void OptimizedPredictionCollector::add_prediction_values(size_t node,
     const PredictionValues& prediction_values,
     std::vector<double>& combined_average) const {
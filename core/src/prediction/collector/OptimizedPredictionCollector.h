@@ -20,6 +20,7 @@
 
 
 #include "forest/Forest.h"
+#include "prediction/PredictionValuesView.h"
 #include "prediction/collector/PredictionCollector.h"
 
 namespace grf {
@@ -31,17 +32,67 @@ public:
   std::vector<Prediction> collect_predictions(const Forest& forest,
                                               const Data& train_data,
                                               const Data& data,
-                                              const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
-                                              const std::vector<std::vector<bool>>& valid_trees_by_sample,
+                                              const LeafAssignments& leaf_assignments,
                                               bool estimate_variance,
                                               bool estimate_error) const;
 
+  /**
+   * Predicts without materializing the leaf nodes of every sample in every tree.
+   *
+   * Samples are processed in blocks: each block's features are gathered into a tile,
+   * every tree is traversed against the tile, and the leaves' prediction values are
+   * added straight into per-sample accumulators. Peak memory is proportional to the
+   * block size (times the number of trees if variance or error estimates are needed),
+   * rather than to the number of samples times the number of trees.
+   *
+   * OOB prediction goes tree-major instead: each tree is traversed only for its
+   * out-of-bag samples, whose leaf values are scattered into per-sample accumulators.
+   * It requires every tree to store its (sorted) drawn samples.
+   */
+  std::vector<Prediction> collect_predictions(const Forest& forest,
+                                              const Data& data,
+                                              bool estimate_variance,
+                                              bool oob_prediction) const;
+
 private:
+  /**
+   * The number of samples processed together by the fused prediction path.
+   */
+  static const size_t SAMPLE_BLOCK_SIZE = 64;
+
+  /**
+   * The number of samples whose accumulators are kept together by the tree-major OOB
+   * path. This bounds the per-tree leaf values recorded for variance and error estimates.
+   */
+  static const size_t OOB_BLOCK_SIZE = 1024;
+
+  std::vector<Prediction> collect_fused_predictions_batch(const Forest& forest,
+                                                          const Data& data,
+                                                          bool estimate_variance,
+                                                          bool oob_prediction,
+                                                          size_t start,
+                                                          size_t num_samples) const;
+
+  std::vector<Prediction> collect_oob_predictions_batch(const Forest& forest,
+                                                        const Data& data,
+                                                        bool estimate_variance,
+                                                        bool oob_prediction,
+                                                        size_t start,
+                                                        size_t num_samples) const;
+
+  Prediction finalize_prediction(size_t sample,
+                                 size_t num_leaves,
+                                 std::vector<double>& average_value,
+                                 const PredictionValuesView& leaf_values,
+                                 const Forest& forest,
+                                 const Data& data,
+                                 bool estimate_variance,
+                                 bool estimate_error) const;
+
   std::vector<Prediction> collect_predictions_batch(const Forest& forest,
                                                     const Data& train_data,
                                                     const Data& data,
-                                                    const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
-                                                    const std::vector<std::vector<bool>>& valid_trees_by_sample,
+                                                    const LeafAssignments& leaf_assignments,
                                                     bool estimate_variance,
                                                     bool estimate_error,
                                                     size_t start,
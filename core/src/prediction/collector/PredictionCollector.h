@@ -19,6 +19,7 @@
 #define GRF_PREDICTIONCOLLECTOR_H
 
 #include "forest/Forest.h"
+#include "prediction/collector/LeafAssignments.h"
 
 namespace grf {
 
@@ -30,8 +31,7 @@ public:
   virtual std::vector<Prediction> collect_predictions(const Forest& forest,
                                                       const Data& train_data,
                                                       const Data& data,
-                                                      const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
-                                                      const std::vector<std::vector<bool>>& valid_trees_by_sample,
+                                                      const LeafAssignments& leaf_assignments,
                                                       bool estimate_variance,
                                                       bool estimate_error) const = 0;
 };
@@ -0,0 +1,181 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <future>
+#include <stdexcept>
+
+#include "prediction/collector/QuantilePredictionCollector.h"
+#include "commons/utility.h"
+
+namespace grf {
+
+QuantilePredictionCollector::QuantilePredictionCollector(std::vector<double> quantiles, uint num_threads):
+    quantiles(quantiles), num_threads(num_threads) {}
+
+std::vector<Prediction> QuantilePredictionCollector::collect_predictions(const Forest& forest,
+                                                                         const Data& train_data,
+                                                                         const Data& data,
+                                                                         const LeafAssignments& leaf_assignments,
+                                                                         bool estimate_variance,
+                                                                         bool estimate_error) const {
+  if (estimate_variance) {
+    throw std::runtime_error("Variance estimates are not available for quantile forests.");
+  }
+
+  std::shared_ptr<const SortedLeafRanks> ranks = get_sorted_leaf_ranks(forest, train_data);
+
+  size_t num_samples = data.get_num_rows();
+  std::vector<uint> thread_ranges;
+  split_sequence(thread_ranges, 0, static_cast<uint>(num_samples - 1), num_threads);
+
+  std::vector<std::future<std::vector<Prediction>>> futures;
+  futures.reserve(thread_ranges.size());
+
+  std::vector<Prediction> predictions;
+  predictions.reserve(num_samples);
+
+  for (uint i = 0; i < thread_ranges.size() - 1; ++i) {
+    size_t start_index = thread_ranges[i];
+    size_t num_samples_batch = thread_ranges[i + 1] - start_index;
+
+    futures.push_back(std::async(std::launch::async,
+                                 &QuantilePredictionCollector::collect_predictions_batch,
+                                 this,
+                                 std::ref(forest),
+                                 std::ref(leaf_assignments),
+                                 std::ref(*ranks),
+                                 start_index,
+                                 num_samples_batch));
+  }
+
+  for (auto& future : futures) {
+    std::vector<Prediction> thread_predictions = future.get();
+    predictions.insert(predictions.end(),
+                       std::make_move_iterator(thread_predictions.begin()),
+                       std::make_move_iterator(thread_predictions.end()));
+  }
+
+  return predictions;
+}
+
+std::shared_ptr<const SortedLeafRanks> QuantilePredictionCollector::get_sorted_leaf_ranks(
+    const Forest& forest,
+    const Data& train_data) const {
+  std::lock_guard<std::mutex> lock(sorted_leaf_ranks_mutex);
+  if (sorted_leaf_ranks == nullptr || !sorted_leaf_ranks->is_built_from(forest, train_data)) {
+    sorted_leaf_ranks.reset();
+    sorted_leaf_ranks = std::make_shared<const SortedLeafRanks>(forest, train_data, num_threads);
+  }
+  return sorted_leaf_ranks;
+}
+
+std::vector<Prediction> QuantilePredictionCollector::collect_predictions_batch(
+    const Forest& forest,
+    const LeafAssignments& leaf_assignments,
+    const SortedLeafRanks& leaf_ranks,
+    size_t start,
+    size_t num_samples) const {
+  size_t num_trees = forest.get_trees().size();
+  const ValidTreesBySample& valid_trees_by_sample = leaf_assignments.get_valid_trees_by_sample();
+
+  std::vector<Prediction> predictions;
+  predictions.reserve(num_samples);
+
+  // For each leaf the sample falls into: its position in its tree's sorted ranks, the end
+  // of its ranks, its tree and its size. The heap holds the (rank, leaf) at the front of
+  // each leaf, so that leaves are merged in rank order, and equal ranks in tree order.
+  std::vector<size_t> positions;
+  std::vector<size_t> ends;
+  std::vector<size_t> trees;
+  std::vector<size_t> leaf_sizes;
+  std::vector<std::pair<size_t, size_t>> heap;
+  std::greater<std::pair<size_t, size_t>> heap_order;
+
+  for (size_t sample = start; sample < num_samples + start; ++sample) {
+    positions.clear();
+    ends.clear();
+    trees.clear();
+    leaf_sizes.clear();
+    heap.clear();
+    for (size_t tree_index = valid_trees_by_sample.next(sample, 0);
+         tree_index < num_trees;
+         tree_index = valid_trees_by_sample.next(sample, tree_index + 1)) {
+      size_t node = leaf_assignments.get_leaf_node(tree_index, sample);
+      size_t begin = leaf_ranks.get_begin(tree_index, node);
+      size_t end = leaf_ranks.get_end(tree_index, node);
+      if (begin < end) {
+        heap.emplace_back(leaf_ranks.get_ranks(tree_index)[begin], trees.size());
+        positions.push_back(begin);
+        ends.push_back(end);
+        trees.push_back(tree_index);
+        leaf_sizes.push_back(end - begin);
+      }
+    }
+
+    // If this sample has no neighbors, then return placeholder predictions. Note
+    // that this can only occur when honesty is enabled, and is expected to be rare.
+    if (heap.empty()) {
+      predictions.emplace_back(std::vector<double>(quantiles.size(), NAN));
+      continue;
+    }
+    std::make_heap(heap.begin(), heap.end(), heap_order);
+
+    // Every non-empty leaf carries a total weight of 1 / num_leaves.
+    double num_leaves = static_cast<double>(trees.size());
+    std::vector<double> quantile_cutoffs;
+    quantile_cutoffs.reserve(quantiles.size());
+    auto quantile_it = quantiles.begin();
+    double cumulative_weight = 0.0;
+    size_t rank = 0;
+
+    while (!heap.empty() && quantile_it != quantiles.end()) {
+      // Sum the weight of this rank's training sample across all leaves that contain it.
+      rank = heap.front().first;
+      double sample_weight = 0.0;
+      while (!heap.empty() && heap.front().first == rank) {
+        std::pop_heap(heap.begin(), heap.end(), heap_order);
+        size_t leaf = heap.back().second;
+        heap.pop_back();
+        sample_weight += 1.0 / (leaf_sizes[leaf] * num_leaves);
+        if (++positions[leaf] < ends[leaf]) {
+          heap.emplace_back(leaf_ranks.get_ranks(trees[leaf])[positions[leaf]], leaf);
+          std::push_heap(heap.begin(), heap.end(), heap_order);
+        }
+      }
+
+      cumulative_weight += sample_weight;
+      while (quantile_it != quantiles.end() && cumulative_weight >= *quantile_it) {
+        quantile_cutoffs.push_back(leaf_ranks.get_outcome(rank));
+        ++quantile_it;
+      }
+    }
+
+    // Any quantiles not reached are cut off at the largest outcome, which is where the
+    // merge stopped if the heap ran out.
+    for (; quantile_it != quantiles.end(); ++quantile_it) {
+      quantile_cutoffs.push_back(leaf_ranks.get_outcome(rank));
+    }
+    predictions.emplace_back(quantile_cutoffs);
+  }
+
+  return predictions;
+}
+
+} // namespace grf
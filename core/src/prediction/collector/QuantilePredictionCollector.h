@@ -0,0 +1,77 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_QUANTILEPREDICTIONCOLLECTOR_H
+#define GRF_QUANTILEPREDICTIONCOLLECTOR_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "forest/Forest.h"
+#include "prediction/collector/PredictionCollector.h"
+#include "prediction/collector/SortedLeafRanks.h"
+
+namespace grf {
+
+/**
+ * Collects quantile predictions without sorting the neighbors of every test sample.
+ *
+ * The samples of every leaf are kept sorted by outcome rank (see SortedLeafRanks). The
+ * quantiles of a test sample are read off a k-way merge of the sorted lists of the
+ * leaves it falls into, which stops as soon as the largest requested quantile is
+ * reached. Each leaf gives its samples a weight of 1 / (leaf size * number of non-empty
+ * leaves), and the weights of a sample found in several leaves are summed before it is
+ * compared against the quantiles, so ties are resolved as in QuantilePredictionStrategy.
+ * Variance estimates are not available.
+ *
+ * The sorted leaf ranks are built on the first call for a forest, and reused by later
+ * calls with the same forest and training data.
+ */
+class QuantilePredictionCollector final: public PredictionCollector {
+public:
+  QuantilePredictionCollector(std::vector<double> quantiles, uint num_threads);
+
+  std::vector<Prediction> collect_predictions(const Forest& forest,
+                                              const Data& train_data,
+                                              const Data& data,
+                                              const LeafAssignments& leaf_assignments,
+                                              bool estimate_variance,
+                                              bool estimate_error) const;
+
+private:
+  std::shared_ptr<const SortedLeafRanks> get_sorted_leaf_ranks(const Forest& forest,
+                                                               const Data& train_data) const;
+
+  std::vector<Prediction> collect_predictions_batch(const Forest& forest,
+                                                    const LeafAssignments& leaf_assignments,
+                                                    const SortedLeafRanks& leaf_ranks,
+                                                    size_t start,
+                                                    size_t num_samples) const;
+
+  std::vector<double> quantiles;
+  uint num_threads;
+
+  mutable std::mutex sorted_leaf_ranks_mutex;
+  mutable std::shared_ptr<const SortedLeafRanks> sorted_leaf_ranks;
+};
+
+} // namespace grf
+
+#endif //GRF_QUANTILEPREDICTIONCOLLECTOR_H
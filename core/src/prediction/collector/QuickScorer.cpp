@@ -0,0 +1,321 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "commons/utility.h"
+#include "prediction/collector/QuickScorer.h"
+
+namespace grf {
+
+const size_t QuickScorer::MAX_LEAVES;
+const size_t QuickScorer::NOT_COMPILED;
+
+QuickScorer::QuickScorer(const Forest& forest, uint num_threads):
+    forest(forest),
+    num_threads(num_threads),
+    num_vars(0) {
+  const std::vector<std::unique_ptr<Tree>>& trees = forest.get_trees();
+  compiled_index_by_tree.resize(trees.size(), NOT_COMPILED);
+  leaf_offsets.push_back(0);
+
+  std::vector<Condition> conditions;
+  for (size_t tree_index = 0; tree_index < trees.size(); ++tree_index) {
+    const Tree& tree = *trees[tree_index];
+    uint32_t compiled_tree = static_cast<uint32_t>(leaf_offsets.size() - 1);
+    std::vector<Condition> tree_conditions;
+    size_t num_leaves = compile_node(tree, tree.get_root_node(), compiled_tree, 0, tree_conditions);
+    if (num_leaves > MAX_LEAVES) {
+      leaf_nodes.resize(leaf_offsets.back());
+      continue;
+    }
+
+    compiled_index_by_tree[tree_index] = compiled_tree;
+    leaf_offsets.push_back(leaf_nodes.size());
+    conditions.insert(conditions.end(), tree_conditions.begin(), tree_conditions.end());
+  }
+
+  for (const Condition& condition : conditions) {
+    num_vars = std::max(num_vars, condition.var + 1);
+  }
+
+  // Split the conditions by how a sample can fail them.
+  std::vector<Condition> ordered;
+  std::vector<Condition> missing;
+  std::vector<Condition> present;
+  for (const Condition& condition : conditions) {
+    if (std::isnan(condition.threshold)) {
+      present.push_back(condition);
+    } else {
+      ordered.push_back(condition);
+      if (!condition.send_missing_left) {
+        missing.push_back(condition);
+      }
+    }
+  }
+  std::stable_sort(ordered.begin(), ordered.end(), [](const Condition& a, const Condition& b) {
+    return a.threshold < b.threshold;
+  });
+
+  for (const Condition& condition : group_by_var(ordered, ordered_offsets)) {
+    ordered_thresholds.push_back(condition.threshold);
+    ordered_trees.push_back(condition.tree);
+    ordered_masks.push_back(condition.mask);
+  }
+  for (const Condition& condition : group_by_var(missing, missing_offsets)) {
+    missing_trees.push_back(condition.tree);
+    missing_masks.push_back(condition.mask);
+  }
+  for (const Condition& condition : group_by_var(present, present_offsets)) {
+    present_trees.push_back(condition.tree);
+    present_masks.push_back(condition.mask);
+  }
+
+  for (size_t var = 0; var < num_vars; ++var) {
+    if (ordered_offsets[var + 1] > ordered_offsets[var] || present_offsets[var + 1] > present_offsets[var]) {
+      split_vars.push_back(var);
+    }
+  }
+}
+
+bool QuickScorer::can_compile_all_trees(const Forest& forest) {
+  std::vector<size_t> stack;
+  for (const std::unique_ptr<Tree>& tree : forest.get_trees()) {
+    size_t num_leaves = 0;
+    stack.assign(1, tree->get_root_node());
+    while (!stack.empty()) {
+      size_t node = stack.back();
+      stack.pop_back();
+      if (tree->is_leaf(node)) {
+        if (++num_leaves > MAX_LEAVES) {
+          return false;
+        }
+      } else {
+        stack.push_back(tree->get_left_child(node));
+        stack.push_back(tree->get_right_child(node));
+      }
+    }
+  }
+  return true;
+}
+
+template<typename Node>
+std::vector<std::vector<Node>> QuickScorer::get_leaf_nodes(const Data& data) const {
+  size_t num_trees = forest.get_trees().size();
+  size_t num_samples = data.get_num_rows();
+
+  std::vector<uint> thread_ranges;
+  split_sequence(thread_ranges, 0, static_cast<uint>(num_samples - 1), num_threads);
+
+  std::vector<std::future<std::vector<std::vector<Node>>>> futures;
+  futures.reserve(thread_ranges.size());
+
+  for (uint i = 0; i < thread_ranges.size() - 1; ++i) {
+    size_t start_index = thread_ranges[i];
+    size_t num_samples_batch = thread_ranges[i + 1] - start_index;
+
+    futures.push_back(std::async(std::launch::async,
+                                 &QuickScorer::get_leaf_nodes_batch<Node>,
+                                 this,
+                                 std::ref(data),
+                                 start_index,
+                                 num_samples_batch));
+  }
+
+  std::vector<std::vector<Node>> leaf_nodes_by_tree(num_trees);
+  for (auto& leaf_nodes : leaf_nodes_by_tree) {
+    leaf_nodes.reserve(num_samples);
+  }
+  for (auto& future : futures) {
+    std::vector<std::vector<Node>> thread_leaf_nodes = future.get();
+    for (size_t tree_index = 0; tree_index < num_trees; ++tree_index) {
+      leaf_nodes_by_tree[tree_index].insert(leaf_nodes_by_tree[tree_index].end(),
+                                            thread_leaf_nodes[tree_index].begin(),
+                                            thread_leaf_nodes[tree_index].end());
+    }
+  }
+  return leaf_nodes_by_tree;
+}
+
+template std::vector<std::vector<size_t>> QuickScorer::get_leaf_nodes<size_t>(const Data& data) const;
+template std::vector<std::vector<uint32_t>> QuickScorer::get_leaf_nodes<uint32_t>(const Data& data) const;
+
+size_t QuickScorer::get_num_compiled_trees() const {
+  return leaf_offsets.size() - 1;
+}
+
+size_t QuickScorer::compile_node(const Tree& tree,
+                                 size_t node,
+                                 uint32_t compiled_tree,
+                                 size_t first_leaf,
+                                 std::vector<Condition>& conditions) {
+  if (tree.is_leaf(node)) {
+    leaf_nodes.push_back(node);
+    return 1;
+  }
+
+  size_t num_left_leaves = compile_node(tree, tree.get_left_child(node), compiled_tree, first_leaf, conditions);
+  size_t num_right_leaves = compile_node(tree, tree.get_right_child(node), compiled_tree,
+                                         first_leaf + num_left_leaves, conditions);
+
+  // Failing this node's condition rules out every leaf of its left subtree.
+  if (first_leaf + num_left_leaves <= MAX_LEAVES) {
+    uint64_t left_leaves = (num_left_leaves == 64 ? ~uint64_t(0) : ((uint64_t(1) << num_left_leaves) - 1)) << first_leaf;
+    Condition condition;
+    condition.var = tree.get_split_var(node);
+    condition.threshold = tree.get_split_value(node);
+    condition.send_missing_left = tree.get_send_missing_left(node);
+    condition.tree = compiled_tree;
+    condition.mask = ~left_leaves;
+    conditions.push_back(condition);
+  }
+  return num_left_leaves + num_right_leaves;
+}
+
+std::vector<QuickScorer::Condition> QuickScorer::group_by_var(const std::vector<Condition>& conditions,
+                                                              std::vector<size_t>& offsets) const {
+  offsets.assign(num_vars + 1, 0);
+  for (const Condition& condition : conditions) {
+    offsets[condition.var + 1]++;
+  }
+  for (size_t var = 0; var < num_vars; ++var) {
+    offsets[var + 1] += offsets[var];
+  }
+
+  std::vector<Condition> grouped(conditions.size());
+  std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+  for (const Condition& condition : conditions) {
+    grouped[next[condition.var]++] = condition;
+  }
+  return grouped;
+}
+
+template<typename Node>
+std::vector<std::vector<Node>> QuickScorer::get_leaf_nodes_batch(const Data& data,
+                                                                 size_t start,
+                                                                 size_t num_samples) const {
+  const std::vector<std::unique_ptr<Tree>>& trees = forest.get_trees();
+  size_t num_compiled_trees = get_num_compiled_trees();
+
+  std::vector<std::vector<Node>> leaf_nodes_by_tree(trees.size(), std::vector<Node>(num_samples));
+  std::vector<uint64_t> leaf_bits;
+
+  size_t sample = start;
+  while (sample < start + num_samples) {
+    size_t num_scored = 1;
+#ifdef __AVX2__
+    if (sample + 4 <= start + num_samples) {
+      num_scored = 4;
+      leaf_bits.assign(num_compiled_trees * 4, ~uint64_t(0));
+      score_samples_avx2(data, sample, leaf_bits);
+    }
+#endif
+    if (num_scored == 1) {
+      leaf_bits.assign(num_compiled_trees, ~uint64_t(0));
+      score_sample(data, sample, leaf_bits);
+    }
+
+    for (size_t tree_index = 0; tree_index < trees.size(); ++tree_index) {
+      size_t compiled_tree = compiled_index_by_tree[tree_index];
+      for (size_t lane = 0; lane < num_scored; ++lane) {
+        size_t node;
+        if (compiled_tree == NOT_COMPILED) {
+          node = trees[tree_index]->find_leaf_node(data, sample + lane);
+        } else {
+          uint64_t bits = leaf_bits[compiled_tree * num_scored + lane];
+          node = leaf_nodes[leaf_offsets[compiled_tree] + count_trailing_zeros(bits)];
+        }
+        leaf_nodes_by_tree[tree_index][sample + lane - start] = static_cast<Node>(node);
+      }
+    }
+    sample += num_scored;
+  }
+  return leaf_nodes_by_tree;
+}
+
+void QuickScorer::score_sample(const Data& data,
+                               size_t sample,
+                               std::vector<uint64_t>& leaf_bits) const {
+  for (size_t var : split_vars) {
+    double value = data.get(sample, var);
+    if (std::isnan(value)) {
+      apply_conditions(missing_offsets[var], missing_offsets[var + 1], missing_trees, missing_masks,
+                       leaf_bits.data(), 1);
+      continue;
+    }
+
+    apply_conditions(present_offsets[var], present_offsets[var + 1], present_trees, present_masks,
+                     leaf_bits.data(), 1);
+    for (size_t i = ordered_offsets[var]; i < ordered_offsets[var + 1] && ordered_thresholds[i] < value; ++i) {
+      leaf_bits[ordered_trees[i]] &= ordered_masks[i];
+    }
+  }
+}
+
+#ifdef __AVX2__
+void QuickScorer::score_samples_avx2(const Data& data,
+                                     size_t sample,
+                                     std::vector<uint64_t>& leaf_bits) const {
+  const __m256i all_ones = _mm256_set1_epi64x(-1);
+  double values[4];
+
+  for (size_t var : split_vars) {
+    for (size_t lane = 0; lane < 4; ++lane) {
+      values[lane] = data.get(sample + lane, var);
+      if (std::isnan(values[lane])) {
+        apply_conditions(missing_offsets[var], missing_offsets[var + 1], missing_trees, missing_masks,
+                         leaf_bits.data() + lane, 4);
+      } else {
+        apply_conditions(present_offsets[var], present_offsets[var + 1], present_trees, present_masks,
+                         leaf_bits.data() + lane, 4);
+      }
+    }
+
+    // Missing values never compare greater than a threshold, so they are left untouched.
+    __m256d lane_values = _mm256_loadu_pd(values);
+    for (size_t i = ordered_offsets[var]; i < ordered_offsets[var + 1]; ++i) {
+      __m256d fails = _mm256_cmp_pd(_mm256_set1_pd(ordered_thresholds[i]), lane_values, _CMP_LT_OQ);
+      if (_mm256_movemask_pd(fails) == 0) {
+        break;
+      }
+      __m256i* bits = reinterpret_cast<__m256i*>(leaf_bits.data() + ordered_trees[i] * 4);
+      __m256i keep = _mm256_or_si256(_mm256_set1_epi64x(static_cast<long long>(ordered_masks[i])),
+                                     _mm256_xor_si256(_mm256_castpd_si256(fails), all_ones));
+      _mm256_storeu_si256(bits, _mm256_and_si256(_mm256_loadu_si256(bits), keep));
+    }
+  }
+}
+#endif
+
+void QuickScorer::apply_conditions(size_t begin,
+                                   size_t end,
+                                   const std::vector<uint32_t>& trees,
+                                   const std::vector<uint64_t>& masks,
+                                   uint64_t* leaf_bits,
+                                   size_t stride) const {
+  for (size_t i = begin; i < end; ++i) {
+    leaf_bits[trees[i] * stride] &= masks[i];
+  }
+}
+
+} // namespace grf
@@ -0,0 +1,180 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_QUICKSCORER_H
+#define GRF_QUICKSCORER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "commons/Data.h"
+#include "forest/Forest.h"
+
+namespace grf {
+
+/**
+ * An alternative to TreeTraverser for forests of shallow trees, following QuickScorer.
+ *
+ * Rather than chasing pointers down each tree, the forest is precompiled into a list of
+ * split conditions per variable, sorted by threshold. Every tree with at most 64 leaves
+ * numbers its leaves from left to right, and each of its split nodes is given a bitmask
+ * clearing the leaves of its left subtree. To score a sample, every tree starts with all
+ * of its leaves set, and for each variable the conditions the sample fails (those sending
+ * it right) are applied by and-ing in their masks. As the conditions are sorted, this
+ * stops at the first threshold no smaller than the sample's value. The leaf the sample
+ * reaches is then the leftmost leaf still set.
+ *
+ * Missing values are encoded through separate condition lists: a missing value fails the
+ * conditions of nodes that send missing values right, and a present value fails the
+ * conditions of nodes that split on missingness.
+ *
+ * If compiled with AVX2 support (see the GRF_AVX2 CMake option), four samples are scored
+ * at a time. Otherwise a portable scalar loop is used. Trees with more than 64 leaves fall
+ * back to Tree::find_leaf_node. In all cases the leaf nodes are the same as those found by
+ * traversing each tree. TreeTraverser uses this scorer for forests whose trees can all be
+ * compiled.
+ */
+class QuickScorer {
+public:
+  QuickScorer(const Forest& forest, uint num_threads);
+
+  /**
+   * Whether every tree of the forest has at most 64 leaves, so that none of them
+   * falls back to traversal.
+   */
+  static bool can_compile_all_trees(const Forest& forest);
+
+  /**
+   * Finds the leaf node of every sample in every tree, in the same layout as
+   * TreeTraverser::get_leaf_nodes without OOB prediction.
+   */
+  template<typename Node>
+  std::vector<std::vector<Node>> get_leaf_nodes(const Data& data) const;
+
+  /**
+   * The number of trees that were compiled into bitmasks, as opposed to falling
+   * back to traversal because they have more than 64 leaves.
+   */
+  size_t get_num_compiled_trees() const;
+
+private:
+  /**
+   * The largest number of leaves a tree may have to be compiled into bitmasks.
+   */
+  static const size_t MAX_LEAVES = 64;
+
+  /**
+   * Marks a tree that falls back to traversal in compiled_index_by_tree.
+   */
+  static const size_t NOT_COMPILED = static_cast<size_t>(-1);
+
+  /**
+   * A split node of a compiled tree, before the conditions are grouped by variable.
+   */
+  struct Condition {
+    size_t var;
+    double threshold;
+    bool send_missing_left;
+    uint32_t tree;
+    uint64_t mask;
+  };
+
+  /**
+   * Numbers the leaves below the given node from left to right, starting at first_leaf,
+   * and records a condition for every split node. Returns the number of leaves below it.
+   */
+  size_t compile_node(const Tree& tree,
+                      size_t node,
+                      uint32_t compiled_tree,
+                      size_t first_leaf,
+                      std::vector<Condition>& conditions);
+
+  /**
+   * Stably groups the conditions by variable, filling in the offset of each variable's
+   * conditions within the result.
+   */
+  std::vector<Condition> group_by_var(const std::vector<Condition>& conditions,
+                                      std::vector<size_t>& offsets) const;
+
+  template<typename Node>
+  std::vector<std::vector<Node>> get_leaf_nodes_batch(const Data& data,
+                                                      size_t start,
+                                                      size_t num_samples) const;
+
+  /**
+   * Applies every condition a sample fails to leaf_bits, which holds one word per
+   * compiled tree with all leaves initially set.
+   */
+  void score_sample(const Data& data,
+                    size_t sample,
+                    std::vector<uint64_t>& leaf_bits) const;
+
+#ifdef __AVX2__
+  /**
+   * Scores four consecutive samples at once, with leaf_bits holding four words
+   * (one per sample) for each compiled tree.
+   */
+  void score_samples_avx2(const Data& data,
+                          size_t sample,
+                          std::vector<uint64_t>& leaf_bits) const;
+#endif
+
+  /**
+   * And-s the masks of the conditions in [begin, end) into the leaf bits of their trees,
+   * where the words of consecutive compiled trees are stride apart.
+   */
+  void apply_conditions(size_t begin,
+                        size_t end,
+                        const std::vector<uint32_t>& trees,
+                        const std::vector<uint64_t>& masks,
+                        uint64_t* leaf_bits,
+                        size_t stride) const;
+
+  const Forest& forest;
+  uint num_threads;
+
+  // The variables that compiled trees split on, and one past the largest of them.
+  std::vector<size_t> split_vars;
+  size_t num_vars;
+
+  // For each tree of the forest, its index among the compiled trees, or NOT_COMPILED.
+  std::vector<size_t> compiled_index_by_tree;
+  // The node ID of each compiled tree's leaves, from left to right.
+  std::vector<size_t> leaf_offsets;
+  std::vector<size_t> leaf_nodes;
+
+  // Conditions with a threshold, sorted by threshold within each variable. A present
+  // value fails those with a smaller threshold.
+  std::vector<size_t> ordered_offsets;
+  std::vector<double> ordered_thresholds;
+  std::vector<uint32_t> ordered_trees;
+  std::vector<uint64_t> ordered_masks;
+
+  // Conditions a missing value fails: those with a threshold that send missing values right.
+  std::vector<size_t> missing_offsets;
+  std::vector<uint32_t> missing_trees;
+  std::vector<uint64_t> missing_masks;
+
+  // Conditions a present value fails: those that split on missingness.
+  std::vector<size_t> present_offsets;
+  std::vector<uint32_t> present_trees;
+  std::vector<uint64_t> present_masks;
+};
+
+} // namespace grf
+
+#endif //GRF_QUICKSCORER_H
@@ -15,56 +15,113 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
+#include <algorithm>
+#include <stdexcept>
+
 #include "SampleWeightComputer.h"
 
 #include "tree/Tree.h"
 
 namespace grf {
 
-std::unordered_map<size_t, double> SampleWeightComputer::compute_weights(size_t sample,
-                                                                         const Forest& forest,
-                                                                         const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
-                                                                         const std::vector<std::vector<bool>>& valid_trees_by_sample) const {
-  std::unordered_map<size_t, double> weights_by_sample;
+SampleWeightComputer::SampleWeightComputer(size_t num_train_samples):
+    dense_weights(num_train_samples) {}
 
+void SampleWeightComputer::compute_weights(size_t sample,
+                                           const Forest& forest,
+                                           const LeafAssignments& leaf_assignments,
+                                           std::vector<std::pair<size_t, double>>& weights_by_sample) {
   // Create a list of weighted neighbors for this sample.
-  for (size_t tree_index = 0; tree_index < forest.get_trees().size(); ++tree_index) {
-    if (!valid_trees_by_sample[sample][tree_index]) {
-      continue;
-    }
+  const ValidTreesBySample& valid_trees_by_sample = leaf_assignments.get_valid_trees_by_sample();
+  size_t num_trees = forest.get_trees().size();
+  for (size_t tree_index = valid_trees_by_sample.next(sample, 0);
+       tree_index < num_trees;
+       tree_index = valid_trees_by_sample.next(sample, tree_index + 1)) {
+
+    size_t node = leaf_assignments.get_leaf_node(tree_index, sample);
+    add_leaf_weights(*forest.get_trees()[tree_index], node);
+  }
 
-    const std::vector<size_t>& leaf_nodes = leaf_nodes_by_tree.at(tree_index);
-    size_t node = leaf_nodes.at(sample);
+  normalize_sample_weights(weights_by_sample);
+}
 
-    const std::unique_ptr<Tree>& tree = forest.get_trees()[tree_index];
-    const std::vector<size_t>& samples = tree->get_leaf_samples()[node];
-    if (!samples.empty()) {
-      add_sample_weights(samples, weights_by_sample);
-    }
+void SampleWeightComputer::compute_weights(size_t sample,
+                                           const Forest& forest,
+                                           const Data& data,
+                                           const ValidTreesBySample& valid_trees_by_sample,
+                                           std::vector<std::pair<size_t, double>>& weights_by_sample) {
+  size_t num_trees = forest.get_trees().size();
+  for (size_t tree_index = valid_trees_by_sample.next(sample, 0);
+       tree_index < num_trees;
+       tree_index = valid_trees_by_sample.next(sample, tree_index + 1)) {
+    const Tree& tree = *forest.get_trees()[tree_index];
+    add_leaf_weights(tree, tree.find_leaf_node(data, sample));
   }
 
   normalize_sample_weights(weights_by_sample);
-  return weights_by_sample;
 }
 
-void SampleWeightComputer::add_sample_weights(const std::vector<size_t>& samples,
-                                              std::unordered_map<size_t, double>& weights_by_sample) const {
+size_t SampleWeightComputer::count_weights(size_t sample,
+                                           const Forest& forest,
+                                           const Data& data,
+                                           const ValidTreesBySample& valid_trees_by_sample) {
+  size_t num_trees = forest.get_trees().size();
+  for (size_t tree_index = valid_trees_by_sample.next(sample, 0);
+       tree_index < num_trees;
+       tree_index = valid_trees_by_sample.next(sample, tree_index + 1)) {
+    const Tree& tree = *forest.get_trees()[tree_index];
+    add_leaf_weights(tree, tree.find_leaf_node(data, sample));
+  }
+
+  size_t num_weights = touched_samples.size();
+  reset_sample_weights();
+  return num_weights;
+}
+
+void SampleWeightComputer::add_leaf_weights(const Tree& tree, size_t node) {
+  if (!tree.has_leaf_samples()) {
+    throw std::runtime_error("Sample weights cannot be computed for a forest trained without "
+                             "keeping its leaf samples.");
+  }
+  SampleSpan samples = tree.get_leaf_samples(node);
+  if (!samples.empty()) {
+    add_sample_weights(samples);
+  }
+}
+
+void SampleWeightComputer::add_sample_weights(const SampleSpan& samples) {
   double sample_weight = 1.0 / samples.size();
 
-  for (auto& sample : samples) {
-    weights_by_sample[sample] += sample_weight;
+  for (size_t sample : samples) {
+    if (dense_weights[sample] == 0.0) {
+      touched_samples.push_back(sample);
+    }
+    dense_weights[sample] += sample_weight;
   }
 }
 
-void SampleWeightComputer::normalize_sample_weights(std::unordered_map<size_t, double>& weights_by_sample) const {
+void SampleWeightComputer::normalize_sample_weights(std::vector<std::pair<size_t, double>>& weights_by_sample) {
+  std::sort(touched_samples.begin(), touched_samples.end());
+
   double total_weight = 0.0;
-  for (const auto& entry : weights_by_sample) {
-    total_weight += entry.second;
+  for (size_t sample : touched_samples) {
+    total_weight += dense_weights[sample];
+  }
+
+  // Read out the touched entries, then reset them for the next test sample.
+  weights_by_sample.clear();
+  weights_by_sample.reserve(touched_samples.size());
+  for (size_t sample : touched_samples) {
+    weights_by_sample.emplace_back(sample, dense_weights[sample] / total_weight);
   }
+  reset_sample_weights();
+}
 
-  for (auto& entry : weights_by_sample) {
-    entry.second/= total_weight;
+void SampleWeightComputer::reset_sample_weights() {
+  for (size_t sample : touched_samples) {
+    dense_weights[sample] = 0.0;
   }
+  touched_samples.clear();
 }
 
 } // namespace grf
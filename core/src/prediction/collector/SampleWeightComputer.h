@@ -19,24 +19,65 @@
 #define GRF_SAMPLEWEIGHTCOMPUTER_H
 
 #include "forest/Forest.h"
+#include "prediction/collector/LeafAssignments.h"
+#include "prediction/collector/ValidTreesBySample.h"
 
-#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace grf {
 
+/**
+ * Computes the forest weights of the training samples for a test sample.
+ *
+ * Weights are accumulated into a dense buffer over the training samples, together with
+ * a list of the samples touched so far. Once all trees are added, only the touched
+ * entries are read out and reset, so the buffer is ready for the next test sample.
+ * Because of this state, each thread should use its own computer.
+ */
 class SampleWeightComputer {
 public:
-  std::unordered_map<size_t, double> compute_weights(size_t sample,
-                                                     const Forest& forest,
-                                                     const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
-                                                     const std::vector<std::vector<bool>>& valid_trees_by_sample) const;
+  SampleWeightComputer(size_t num_train_samples);
+
+  /**
+   * Fills weights_by_sample with the normalized weight of every neighboring training
+   * sample, sorted by sample ID.
+   */
+  void compute_weights(size_t sample,
+                       const Forest& forest,
+                       const LeafAssignments& leaf_assignments,
+                       std::vector<std::pair<size_t, double>>& weights_by_sample);
+
+  /**
+   * As above, but finds the test sample's leaf in each tree by traversing it, rather
+   * than reading it from precomputed leaf assignments for all samples and trees.
+   */
+  void compute_weights(size_t sample,
+                       const Forest& forest,
+                       const Data& data,
+                       const ValidTreesBySample& valid_trees_by_sample,
+                       std::vector<std::pair<size_t, double>>& weights_by_sample);
+
+  /**
+   * Returns the number of neighboring training samples of a test sample, that is the
+   * number of weights compute_weights would fill in, without computing the weights.
+   */
+  size_t count_weights(size_t sample,
+                       const Forest& forest,
+                       const Data& data,
+                       const ValidTreesBySample& valid_trees_by_sample);
 
 private:
-  void add_sample_weights(const std::vector<size_t>& samples,
-                          std::unordered_map<size_t, double>& weights_by_sample) const;
+  void add_leaf_weights(const Tree& tree, size_t node);
+
+  void add_sample_weights(const SampleSpan& samples);
+
+  void normalize_sample_weights(std::vector<std::pair<size_t, double>>& weights_by_sample);
+
+  void reset_sample_weights();
 
-  void normalize_sample_weights(std::unordered_map<size_t, double>& weights_by_sample) const;
+  std::vector<double> dense_weights;
+  std::vector<size_t> touched_samples;
 };
 
 } // namespace grf
@@ -0,0 +1,113 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <future>
+#include <numeric>
+#include <stdexcept>
+
+#include "prediction/collector/SortedLeafRanks.h"
+#include "commons/utility.h"
+
+namespace grf {
+
+SortedLeafRanks::SortedLeafRanks(const Forest& forest,
+                                 const Data& train_data,
+                                 uint num_threads):
+    forest(&forest),
+    train_data(&train_data),
+    num_trees(forest.get_trees().size()),
+    num_train_samples(train_data.get_num_rows()),
+    ranks_by_tree(num_trees),
+    offsets_by_tree(num_trees) {
+  // Rank the training samples by outcome, using the sample ID as a tie-breaker so
+  // that predictions are deterministic.
+  std::vector<size_t> samples_by_rank(num_train_samples);
+  std::iota(samples_by_rank.begin(), samples_by_rank.end(), 0);
+  std::sort(samples_by_rank.begin(), samples_by_rank.end(),
+            [&](size_t first, size_t second) {
+              double first_outcome = train_data.get_outcome(first);
+              double second_outcome = train_data.get_outcome(second);
+              return first_outcome < second_outcome || (first_outcome == second_outcome && first < second);
+            });
+
+  std::vector<size_t> rank_by_sample(num_train_samples);
+  sorted_outcomes.resize(num_train_samples);
+  for (size_t rank = 0; rank < num_train_samples; ++rank) {
+    rank_by_sample[samples_by_rank[rank]] = rank;
+    sorted_outcomes[rank] = train_data.get_outcome(samples_by_rank[rank]);
+  }
+
+  if (num_trees == 0) {
+    return;
+  }
+  std::vector<uint> tree_ranges;
+  split_sequence(tree_ranges, 0, static_cast<uint>(num_trees - 1), num_threads);
+  std::vector<std::future<void>> futures;
+  futures.reserve(tree_ranges.size());
+  for (uint i = 0; i < tree_ranges.size() - 1; ++i) {
+    size_t start_index = tree_ranges[i];
+    size_t num_trees_batch = tree_ranges[i + 1] - start_index;
+    futures.push_back(std::async(std::launch::async,
+                                 &SortedLeafRanks::sort_batch,
+                                 this,
+                                 start_index,
+                                 num_trees_batch,
+                                 std::ref(forest),
+                                 std::ref(rank_by_sample)));
+  }
+  for (auto& future : futures) {
+    future.get();
+  }
+}
+
+bool SortedLeafRanks::is_built_from(const Forest& forest,
+                                    const Data& train_data) const {
+  return this->forest == &forest && this->train_data == &train_data
+      && num_trees == forest.get_trees().size() && num_train_samples == train_data.get_num_rows();
+}
+
+void SortedLeafRanks::sort_batch(size_t start,
+                                 size_t num_trees,
+                                 const Forest& forest,
+                                 const std::vector<size_t>& rank_by_sample) {
+  for (size_t tree_index = start; tree_index < start + num_trees; ++tree_index) {
+    const std::unique_ptr<Tree>& tree = forest.get_trees()[tree_index];
+    if (!tree->has_leaf_samples()) {
+      throw std::runtime_error("Quantile predictions cannot be computed for a forest trained without "
+                               "keeping its leaf samples.");
+    }
+
+    // The ranks of node i's samples are stored, sorted, between offsets i and i + 1.
+    size_t num_nodes = tree->get_num_nodes();
+    std::vector<size_t>& ranks = ranks_by_tree[tree_index];
+    std::vector<size_t>& offsets = offsets_by_tree[tree_index];
+    offsets.resize(num_nodes + 1);
+    for (size_t node = 0; node < num_nodes; ++node) {
+      offsets[node] = ranks.size();
+      if (tree->is_leaf(node)) {
+        for (size_t sample : tree->get_leaf_samples(node)) {
+          ranks.push_back(rank_by_sample[sample]);
+        }
+        std::sort(ranks.begin() + offsets[node], ranks.end());
+      }
+    }
+    offsets[num_nodes] = ranks.size();
+  }
+}
+
+} // namespace grf
@@ -0,0 +1,98 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_SORTEDLEAFRANKS_H
+#define GRF_SORTEDLEAFRANKS_H
+
+#include <cstddef>
+#include <vector>
+
+#include "commons/Data.h"
+#include "forest/Forest.h"
+
+namespace grf {
+
+/**
+ * The samples of every leaf of a forest, as ranks of their training outcomes in
+ * increasing order, so that the neighbors of a test sample can be visited in outcome
+ * order by merging the lists of its leaves.
+ *
+ * Training samples are ranked by outcome, with ties broken by sample ID. Building the
+ * ranks costs O(n log n) for n training samples plus sorting the samples of each leaf,
+ * so they are meant to be built once per forest and reused across predictions.
+ */
+class SortedLeafRanks {
+public:
+  SortedLeafRanks(const Forest& forest,
+                  const Data& train_data,
+                  uint num_threads);
+
+  /**
+   * Whether these ranks were built from the given forest and training data. The objects
+   * are compared by identity, so they must not be modified while the ranks are reused.
+   */
+  bool is_built_from(const Forest& forest,
+                     const Data& train_data) const;
+
+  /**
+   * The training outcome with the given rank.
+   */
+  double get_outcome(size_t rank) const;
+
+  /**
+   * The ranks of the samples in the given node of a tree are stored, sorted, in
+   * [get_ranks(tree) + get_begin(tree, node), get_ranks(tree) + get_end(tree, node)).
+   */
+  const size_t* get_ranks(size_t tree) const;
+  size_t get_begin(size_t tree, size_t node) const;
+  size_t get_end(size_t tree, size_t node) const;
+
+private:
+  void sort_batch(size_t start,
+                  size_t num_trees,
+                  const Forest& forest,
+                  const std::vector<size_t>& rank_by_sample);
+
+  const Forest* forest;
+  const Data* train_data;
+  size_t num_trees;
+  size_t num_train_samples;
+
+  std::vector<double> sorted_outcomes;
+  std::vector<std::vector<size_t>> ranks_by_tree;
+  std::vector<std::vector<size_t>> offsets_by_tree;
+};
+
+inline double SortedLeafRanks::get_outcome(size_t rank) const {
+  return sorted_outcomes[rank];
+}
+
+inline const size_t* SortedLeafRanks::get_ranks(size_t tree) const {
+  return ranks_by_tree[tree].data();
+}
+
+inline size_t SortedLeafRanks::get_begin(size_t tree, size_t node) const {
+  return offsets_by_tree[tree][node];
+}
+
+inline size_t SortedLeafRanks::get_end(size_t tree, size_t node) const {
+  return offsets_by_tree[tree][node + 1];
+}
+
+} // namespace grf
+
+#endif //GRF_SORTEDLEAFRANKS_H
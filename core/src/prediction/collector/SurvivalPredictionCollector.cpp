@@ -0,0 +1,277 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <stdexcept>
+
+#include "prediction/collector/SurvivalPredictionCollector.h"
+#include "commons/utility.h"
+
+namespace grf {
+
+SurvivalPredictionCollector::SurvivalPredictionCollector(size_t num_failures,
+                                                         int prediction_type,
+                                                         uint num_threads):
+    strategy(num_failures, prediction_type),
+    num_failures(num_failures),
+    num_threads(num_threads) {}
+
+std::vector<Prediction> SurvivalPredictionCollector::collect_predictions(const Forest& forest,
+                                                                         const Data& train_data,
+                                                                         const Data& data,
+                                                                         const LeafAssignments& leaf_assignments,
+                                                                         bool estimate_variance,
+                                                                         bool estimate_error) const {
+  // For each tree, the table of node i is stored between offsets i and i + 1 of its times,
+  // failures and censors, sorted by time. The total sample weight of each node is kept
+  // separately, to detect leaves whose samples all have zero weight.
+  size_t num_trees = forest.get_trees().size();
+  std::vector<std::vector<size_t>> offsets_by_tree(num_trees);
+  std::vector<std::vector<size_t>> times_by_tree(num_trees);
+  std::vector<std::vector<double>> failures_by_tree(num_trees);
+  std::vector<std::vector<double>> censors_by_tree(num_trees);
+  std::vector<std::vector<double>> weights_by_tree(num_trees);
+
+  std::vector<uint> tree_ranges;
+  split_sequence(tree_ranges, 0, static_cast<uint>(num_trees - 1), num_threads);
+  std::vector<std::future<void>> table_futures;
+  table_futures.reserve(tree_ranges.size());
+  for (uint i = 0; i < tree_ranges.size() - 1; ++i) {
+    size_t start_index = tree_ranges[i];
+    size_t num_trees_batch = tree_ranges[i + 1] - start_index;
+    table_futures.push_back(std::async(std::launch::async,
+                                       &SurvivalPredictionCollector::compute_leaf_tables_batch,
+                                       this,
+                                       start_index,
+                                       num_trees_batch,
+                                       std::ref(forest),
+                                       std::ref(train_data),
+                                       std::ref(offsets_by_tree),
+                                       std::ref(times_by_tree),
+                                       std::ref(failures_by_tree),
+                                       std::ref(censors_by_tree),
+                                       std::ref(weights_by_tree)));
+  }
+  for (auto& future : table_futures) {
+    future.get();
+  }
+
+  size_t num_samples = data.get_num_rows();
+  std::vector<uint> thread_ranges;
+  split_sequence(thread_ranges, 0, static_cast<uint>(num_samples - 1), num_threads);
+
+  std::vector<std::future<std::vector<Prediction>>> futures;
+  futures.reserve(thread_ranges.size());
+
+  std::vector<Prediction> predictions;
+  predictions.reserve(num_samples);
+
+  for (uint i = 0; i < thread_ranges.size() - 1; ++i) {
+    size_t start_index = thread_ranges[i];
+    size_t num_samples_batch = thread_ranges[i + 1] - start_index;
+
+    futures.push_back(std::async(std::launch::async,
+                                 &SurvivalPredictionCollector::collect_predictions_batch,
+                                 this,
+                                 std::ref(forest),
+                                 std::ref(train_data),
+                                 std::ref(data),
+                                 std::ref(leaf_assignments),
+                                 std::ref(offsets_by_tree),
+                                 std::ref(times_by_tree),
+                                 std::ref(failures_by_tree),
+                                 std::ref(censors_by_tree),
+                                 std::ref(weights_by_tree),
+                                 estimate_variance,
+                                 start_index,
+                                 num_samples_batch));
+  }
+
+  for (auto& future : futures) {
+    std::vector<Prediction> thread_predictions = future.get();
+    predictions.insert(predictions.end(),
+                       std::make_move_iterator(thread_predictions.begin()),
+                       std::make_move_iterator(thread_predictions.end()));
+  }
+
+  return predictions;
+}
+
+void SurvivalPredictionCollector::compute_leaf_tables_batch(size_t start,
+                                                            size_t num_trees,
+                                                            const Forest& forest,
+                                                            const Data& train_data,
+                                                            std::vector<std::vector<size_t>>& offsets_by_tree,
+                                                            std::vector<std::vector<size_t>>& times_by_tree,
+                                                            std::vector<std::vector<double>>& failures_by_tree,
+                                                            std::vector<std::vector<double>>& censors_by_tree,
+                                                            std::vector<std::vector<double>>& weights_by_tree) const {
+  std::vector<double> failures(num_failures + 1);
+  std::vector<double> censors(num_failures + 1);
+  std::vector<size_t> leaf_times;
+
+  for (size_t tree_index = start; tree_index < start + num_trees; ++tree_index) {
+    const std::unique_ptr<Tree>& tree = forest.get_trees()[tree_index];
+    if (!tree->has_leaf_samples()) {
+      throw std::runtime_error("Survival predictions cannot be computed for a forest trained without "
+                               "keeping its leaf samples.");
+    }
+
+    size_t num_nodes = tree->get_num_nodes();
+    std::vector<size_t>& offsets = offsets_by_tree[tree_index];
+    std::vector<size_t>& times = times_by_tree[tree_index];
+    std::vector<double>& tree_failures = failures_by_tree[tree_index];
+    std::vector<double>& tree_censors = censors_by_tree[tree_index];
+    std::vector<double>& weights = weights_by_tree[tree_index];
+    offsets.resize(num_nodes + 1);
+    weights.resize(num_nodes);
+
+    for (size_t node = 0; node < num_nodes; ++node) {
+      offsets[node] = times.size();
+      if (!tree->is_leaf(node)) {
+        continue;
+      }
+
+      SampleSpan samples = tree->get_leaf_samples(node);
+      double sample_fraction = 1.0 / samples.size();
+      leaf_times.clear();
+      for (size_t sample : samples) {
+        size_t time = static_cast<size_t>(train_data.get_outcome(sample));
+        double sample_weight = train_data.get_weight(sample);
+        if (failures[time] == 0.0 && censors[time] == 0.0) {
+          leaf_times.push_back(time);
+        }
+        if (train_data.is_failure(sample)) {
+          failures[time] += sample_weight * sample_fraction;
+        } else {
+          censors[time] += sample_weight * sample_fraction;
+        }
+        weights[node] += sample_weight;
+      }
+
+      // Zero-weight samples may list a time more than once.
+      std::sort(leaf_times.begin(), leaf_times.end());
+      leaf_times.erase(std::unique(leaf_times.begin(), leaf_times.end()), leaf_times.end());
+      for (size_t time : leaf_times) {
+        times.push_back(time);
+        tree_failures.push_back(failures[time]);
+        tree_censors.push_back(censors[time]);
+        failures[time] = 0.0;
+        censors[time] = 0.0;
+      }
+    }
+    offsets[num_nodes] = times.size();
+  }
+}
+
+std::vector<Prediction> SurvivalPredictionCollector::collect_predictions_batch(
+    const Forest& forest,
+    const Data& train_data,
+    const Data& data,
+    const LeafAssignments& leaf_assignments,
+    const std::vector<std::vector<size_t>>& offsets_by_tree,
+    const std::vector<std::vector<size_t>>& times_by_tree,
+    const std::vector<std::vector<double>>& failures_by_tree,
+    const std::vector<std::vector<double>>& censors_by_tree,
+    const std::vector<std::vector<double>>& weights_by_tree,
+    bool estimate_variance,
+    size_t start,
+    size_t num_samples) const {
+  size_t num_trees = forest.get_trees().size();
+  const ValidTreesBySample& valid_trees_by_sample = leaf_assignments.get_valid_trees_by_sample();
+
+  std::vector<Prediction> predictions;
+  predictions.reserve(num_samples);
+
+  // The dense accumulators are indexed by event time, and only the touched times are
+  // read out and reset after each sample.
+  std::vector<double> dense_failures(num_failures + 1);
+  std::vector<double> dense_censors(num_failures + 1);
+  std::vector<bool> is_touched(num_failures + 1);
+  std::vector<size_t> touched_times;
+  std::vector<double> count_failure;
+  std::vector<double> count_censor;
+
+  for (size_t sample = start; sample < num_samples + start; ++sample) {
+    size_t num_leaves = 0;
+    double sum_weight = 0.0;
+    for (size_t tree_index = valid_trees_by_sample.next(sample, 0);
+         tree_index < num_trees;
+         tree_index = valid_trees_by_sample.next(sample, tree_index + 1)) {
+      size_t node = leaf_assignments.get_leaf_node(tree_index, sample);
+      const std::vector<size_t>& offsets = offsets_by_tree[tree_index];
+      if (offsets[node] == offsets[node + 1]) {
+        continue;
+      }
+
+      num_leaves++;
+      sum_weight += weights_by_tree[tree_index][node];
+      for (size_t i = offsets[node]; i < offsets[node + 1]; ++i) {
+        size_t time = times_by_tree[tree_index][i];
+        if (!is_touched[time]) {
+          is_touched[time] = true;
+          touched_times.push_back(time);
+        }
+        dense_failures[time] += failures_by_tree[tree_index][i];
+        dense_censors[time] += censors_by_tree[tree_index][i];
+      }
+    }
+
+    // Each leaf's counts add up to its mean sample weight, so dividing by the number of
+    // leaves gives the same normalization as the forest weights.
+    std::sort(touched_times.begin(), touched_times.end());
+    count_failure.clear();
+    count_censor.clear();
+    double sum = 0.0;
+    for (size_t time : touched_times) {
+      count_failure.push_back(dense_failures[time] / num_leaves);
+      count_censor.push_back(dense_censors[time] / num_leaves);
+      sum += count_failure.back() + count_censor.back();
+      dense_failures[time] = 0.0;
+      dense_censors[time] = 0.0;
+      is_touched[time] = false;
+    }
+
+    // If this sample has no neighbors, or they all have zero weight, then return
+    // placeholder predictions.
+    if (num_leaves == 0 || std::abs(sum_weight) <= 1e-16) {
+      touched_times.clear();
+      std::vector<double> nan(strategy.prediction_length(), NAN);
+      std::vector<double> empty;
+      predictions.emplace_back(nan, estimate_variance ? nan : empty, empty, empty);
+      continue;
+    }
+
+    std::vector<double> point_prediction = strategy.predict_survival_function(touched_times,
+                                                                              count_failure,
+                                                                              count_censor,
+                                                                              sum);
+    touched_times.clear();
+
+    // The strategy's variance estimate does not depend on the sample's neighbors.
+    std::vector<double> variance = estimate_variance
+        ? strategy.compute_variance(sample, {}, {}, train_data, data, forest.get_ci_group_size())
+        : std::vector<double>();
+    predictions.emplace_back(point_prediction, variance, std::vector<double>(), std::vector<double>());
+  }
+
+  return predictions;
+}
+
+} // namespace grf
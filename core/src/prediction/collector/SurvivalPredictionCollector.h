@@ -0,0 +1,85 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_SURVIVALPREDICTIONCOLLECTOR_H
+#define GRF_SURVIVALPREDICTIONCOLLECTOR_H
+
+#include <cstddef>
+#include <vector>
+
+#include "forest/Forest.h"
+#include "prediction/SurvivalPredictionStrategy.h"
+#include "prediction/collector/PredictionCollector.h"
+
+namespace grf {
+
+/**
+ * Collects survival predictions from sparse per-leaf tables of event counts.
+ *
+ * Once per call, every leaf is summarized as a table of (event time, failure count,
+ * censoring count), with each training sample counted by its sample weight divided by
+ * the leaf size. A test sample's tables are then added into a dense accumulator, and the
+ * survival function is only evaluated at the event times its leaves touch, instead of
+ * over every event time for every test sample.
+ *
+ * Predictions agree with SurvivalPredictionStrategy up to rounding.
+ */
+class SurvivalPredictionCollector final: public PredictionCollector {
+public:
+  SurvivalPredictionCollector(size_t num_failures,
+                              int prediction_type,
+                              uint num_threads);
+
+  std::vector<Prediction> collect_predictions(const Forest& forest,
+                                              const Data& train_data,
+                                              const Data& data,
+                                              const LeafAssignments& leaf_assignments,
+                                              bool estimate_variance,
+                                              bool estimate_error) const;
+
+private:
+  void compute_leaf_tables_batch(size_t start,
+                                 size_t num_trees,
+                                 const Forest& forest,
+                                 const Data& train_data,
+                                 std::vector<std::vector<size_t>>& offsets_by_tree,
+                                 std::vector<std::vector<size_t>>& times_by_tree,
+                                 std::vector<std::vector<double>>& failures_by_tree,
+                                 std::vector<std::vector<double>>& censors_by_tree,
+                                 std::vector<std::vector<double>>& weights_by_tree) const;
+
+  std::vector<Prediction> collect_predictions_batch(const Forest& forest,
+                                                    const Data& train_data,
+                                                    const Data& data,
+                                                    const LeafAssignments& leaf_assignments,
+                                                    const std::vector<std::vector<size_t>>& offsets_by_tree,
+                                                    const std::vector<std::vector<size_t>>& times_by_tree,
+                                                    const std::vector<std::vector<double>>& failures_by_tree,
+                                                    const std::vector<std::vector<double>>& censors_by_tree,
+                                                    const std::vector<std::vector<double>>& weights_by_tree,
+                                                    bool estimate_variance,
+                                                    size_t start,
+                                                    size_t num_samples) const;
+
+  SurvivalPredictionStrategy strategy;
+  size_t num_failures;
+  uint num_threads;
+};
+
+} // namespace grf
+
+#endif //GRF_SURVIVALPREDICTIONCOLLECTOR_H
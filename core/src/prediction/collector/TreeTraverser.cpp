@@ -17,11 +17,20 @@
 
 #include "TreeTraverser.h"
 #include "commons/utility.h"
+#include "prediction/collector/QuickScorer.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <future>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
 
 namespace grf {
 
+const size_t TreeTraverser::TREE_BLOCK_SIZE;
+const size_t TreeTraverser::TILE_SIZE;
+
 TreeTraverser::TreeTraverser(uint num_threads) :
     num_threads(num_threads) {}
 
@@ -29,23 +38,49 @@ std::vector<std::vector<size_t>> TreeTraverser::get_leaf_nodes(
     const Forest& forest,
     const Data& data,
     bool oob_prediction) const {
+  return collect_leaf_nodes<size_t>(forest, data, oob_prediction);
+}
+
+LeafAssignments TreeTraverser::get_leaf_assignments(const Forest& forest,
+                                                    const Data& data,
+                                                    bool oob_prediction) const {
+  for (const std::unique_ptr<Tree>& tree : forest.get_trees()) {
+    if (tree->get_num_nodes() > std::numeric_limits<uint32_t>::max()) {
+      throw std::runtime_error("Leaf assignments can only be computed for trees with fewer than 2^32 nodes.");
+    }
+  }
+
+  return LeafAssignments(collect_leaf_nodes<uint32_t>(forest, data, oob_prediction),
+                         get_valid_trees_by_sample(forest, data, oob_prediction),
+                         oob_prediction);
+}
+
+template<typename Node>
+std::vector<std::vector<Node>> TreeTraverser::collect_leaf_nodes(
+    const Forest& forest,
+    const Data& data,
+    bool oob_prediction) const {
+  if (data.get_num_rows() > 0 && QuickScorer::can_compile_all_trees(forest)) {
+    return score_leaf_nodes<Node>(forest, data, oob_prediction);
+  }
+
   size_t num_trees = forest.get_trees().size();
 
-  std::vector<std::vector<size_t>> leaf_nodes_by_tree;
+  std::vector<std::vector<Node>> leaf_nodes_by_tree;
   leaf_nodes_by_tree.reserve(num_trees);
 
   std::vector<uint> thread_ranges;
   split_sequence(thread_ranges, 0, static_cast<uint>(num_trees - 1), num_threads);
 
   std::vector<std::future<
-      std::vector<std::vector<size_t>>>> futures;
+      std::vector<std::vector<Node>>>> futures;
   futures.reserve(thread_ranges.size());
 
   for (uint i = 0; i < thread_ranges.size() - 1; ++i) {
     size_t start_index = thread_ranges[i];
     size_t num_trees_batch = thread_ranges[i + 1] - start_index;
     futures.push_back(std::async(std::launch::async,
-                                 &TreeTraverser::get_leaf_node_batch,
+                                 &TreeTraverser::get_leaf_node_batch<Node>,
                                  this,
                                  start_index,
                                  num_trees_batch,
@@ -55,33 +90,77 @@ std::vector<std::vector<size_t>> TreeTraverser::get_leaf_nodes(
   }
 
   for (auto& future : futures) {
-    std::vector<std::vector<size_t>> leaf_nodes = future.get();
+    std::vector<std::vector<Node>> leaf_nodes = future.get();
     leaf_nodes_by_tree.insert(leaf_nodes_by_tree.end(),
-                              leaf_nodes.begin(),
-                              leaf_nodes.end());
+                              std::make_move_iterator(leaf_nodes.begin()),
+                              std::make_move_iterator(leaf_nodes.end()));
   }
 
   return leaf_nodes_by_tree;
 };
 
-std::vector<std::vector<bool>> TreeTraverser::get_valid_trees_by_sample(const Forest& forest,
-                                                                        const Data& data,
-                                                                        bool oob_prediction) const {
+template<typename Node>
+std::vector<std::vector<Node>> TreeTraverser::score_leaf_nodes(
+    const Forest& forest,
+    const Data& data,
+    bool oob_prediction) const {
+  std::vector<std::vector<Node>> leaf_nodes_by_tree = QuickScorer(forest, num_threads).get_leaf_nodes<Node>(data);
+  if (!oob_prediction) {
+    return leaf_nodes_by_tree;
+  }
+
+  std::vector<bool> drawn;
+  for (size_t tree_idx = 0; tree_idx < leaf_nodes_by_tree.size(); ++tree_idx) {
+    const std::unique_ptr<Tree>& tree = forest.get_trees()[tree_idx];
+    std::vector<Node>& leaf_nodes = leaf_nodes_by_tree[tree_idx];
+    if (tree->has_drawn_samples()) {
+      for (size_t sample : tree->get_drawn_samples()) {
+        leaf_nodes[sample] = 0;
+      }
+    } else {
+      regenerate_drawn_samples(forest, data.get_num_rows(), tree, drawn);
+      for (size_t sample = 0; sample < leaf_nodes.size(); ++sample) {
+        if (drawn[sample]) {
+          leaf_nodes[sample] = 0;
+        }
+      }
+    }
+  }
+  return leaf_nodes_by_tree;
+}
+
+ValidTreesBySample TreeTraverser::get_valid_trees_by_sample(const Forest& forest,
+                                                            const Data& data,
+                                                            bool oob_prediction) const {
   size_t num_trees = forest.get_trees().size();
   size_t num_samples = data.get_num_rows();
 
-  std::vector<std::vector<bool>> result(num_samples, std::vector<bool>(num_trees, true));
-  if (oob_prediction) {
-    for (size_t tree_idx = 0; tree_idx < num_trees; ++tree_idx) {
-      for (size_t sample : forest.get_trees()[tree_idx]->get_drawn_samples()) {
-        result[sample][tree_idx] = false;
+  if (!oob_prediction) {
+    return ValidTreesBySample(num_samples, num_trees);
+  }
+
+  ValidTreesBySample result(num_samples, num_trees, true);
+  std::vector<bool> drawn;
+  for (size_t tree_idx = 0; tree_idx < num_trees; ++tree_idx) {
+    const std::unique_ptr<Tree>& tree = forest.get_trees()[tree_idx];
+    if (tree->has_drawn_samples()) {
+      for (size_t sample : tree->get_drawn_samples()) {
+        result.set_invalid(sample, tree_idx);
+      }
+    } else {
+      regenerate_drawn_samples(forest, num_samples, tree, drawn);
+      for (size_t sample = 0; sample < num_samples; ++sample) {
+        if (drawn[sample]) {
+          result.set_invalid(sample, tree_idx);
+        }
       }
     }
   }
   return result;
 }
 
-std::vector<std::vector<size_t>> TreeTraverser::get_leaf_node_batch(
+template<typename Node>
+std::vector<std::vector<Node>> TreeTraverser::get_leaf_node_batch(
     size_t start,
     size_t num_trees,
     const Forest& forest,
@@ -89,29 +168,100 @@ std::vector<std::vector<size_t>> TreeTraverser::get_leaf_node_batch(
     bool oob_prediction) const {
 
   size_t num_samples = data.get_num_rows();
-  std::vector<std::vector<size_t>> all_leaf_nodes(num_trees);
+  std::vector<std::vector<Node>> all_leaf_nodes(num_trees, std::vector<Node>(num_samples));
 
-  for (size_t i = 0; i < num_trees; ++i) {
-    const std::unique_ptr<Tree>& tree = forest.get_trees()[start + i];
+  // Trees are traversed in blocks, against tiles of samples whose features have been
+  // gathered into a small row-major buffer. Buffers are reused across blocks and tiles.
+  //
+  // For OOB prediction, a tree's drawn samples are sorted, so the ones in each tile are
+  // found by advancing a cursor through them as the tiles progress. Only trees whose drawn
+  // samples must be regenerated need a bitmap over all samples.
+  std::vector<size_t> drawn_cursors(TREE_BLOCK_SIZE);
+  std::vector<std::vector<bool>> regenerated_drawn(TREE_BLOCK_SIZE);
+  std::vector<bool> tile_drawn(TILE_SIZE);
+  std::vector<size_t> column_by_var(data.get_num_cols());
+  std::vector<size_t> block_vars;
+  std::vector<double> tile;
+  std::vector<size_t> tile_samples;
+  std::vector<size_t> tile_leaf_nodes;
+
+  for (size_t block_start = 0; block_start < num_trees; block_start += TREE_BLOCK_SIZE) {
+    size_t block_size = std::min(TREE_BLOCK_SIZE, num_trees - block_start);
+
+    // Only gather the features that the trees in this block split on.
+    block_vars.clear();
+    std::vector<bool> used_vars(data.get_num_cols(), false);
+    for (size_t i = 0; i < block_size; ++i) {
+      const std::unique_ptr<Tree>& tree = forest.get_trees()[start + block_start + i];
+      drawn_cursors[i] = 0;
+      if (oob_prediction && !tree->has_drawn_samples()) {
+        regenerate_drawn_samples(forest, num_samples, tree, regenerated_drawn[i]);
+      }
+      for (size_t node = 0; node < tree->get_num_nodes(); ++node) {
+        if (!tree->is_leaf(node) && !used_vars[tree->get_split_var(node)]) {
+          used_vars[tree->get_split_var(node)] = true;
+          column_by_var[tree->get_split_var(node)] = block_vars.size();
+          block_vars.push_back(tree->get_split_var(node));
+        }
+      }
+    }
+    size_t tile_width = block_vars.size();
 
-    std::vector<bool> valid_samples = get_valid_samples(num_samples, tree, oob_prediction);
-    std::vector<size_t> leaf_nodes = tree->find_leaf_nodes(data, valid_samples);
-    all_leaf_nodes[i] = leaf_nodes;
+    for (size_t tile_start = 0; tile_start < num_samples; tile_start += TILE_SIZE) {
+      size_t tile_size = std::min(TILE_SIZE, num_samples - tile_start);
+
+      // Each feature is read contiguously from the column-major data.
+      tile.resize(tile_size * tile_width);
+      for (size_t column = 0; column < tile_width; ++column) {
+        for (size_t s = 0; s < tile_size; ++s) {
+          tile[s * tile_width + column] = data.get(tile_start + s, block_vars[column]);
+        }
+      }
+
+      for (size_t i = 0; i < block_size; ++i) {
+        const std::unique_ptr<Tree>& tree = forest.get_trees()[start + block_start + i];
+
+        std::fill(tile_drawn.begin(), tile_drawn.end(), false);
+        if (oob_prediction && tree->has_drawn_samples()) {
+          SampleSpan drawn_samples = tree->get_drawn_samples();
+          size_t& cursor = drawn_cursors[i];
+          for (; cursor < drawn_samples.size() && drawn_samples[cursor] < tile_start + tile_size; ++cursor) {
+            tile_drawn[drawn_samples[cursor] - tile_start] = true;
+          }
+        } else if (oob_prediction) {
+          for (size_t s = 0; s < tile_size; ++s) {
+            tile_drawn[s] = regenerated_drawn[i][tile_start + s];
+          }
+        }
+
+        tile_samples.clear();
+        for (size_t s = 0; s < tile_size; ++s) {
+          if (!tile_drawn[s]) {
+            tile_samples.push_back(s);
+          }
+        }
+        tree->find_leaf_nodes(tile.data(), tile_width, column_by_var, tile_samples, tile_leaf_nodes);
+
+        std::vector<Node>& leaf_nodes = all_leaf_nodes[block_start + i];
+        for (size_t j = 0; j < tile_samples.size(); ++j) {
+          leaf_nodes[tile_start + tile_samples[j]] = static_cast<Node>(tile_leaf_nodes[j]);
+        }
+      }
+    }
   }
 
   return all_leaf_nodes;
 }
 
-std::vector<bool> TreeTraverser::get_valid_samples(size_t num_samples,
-                                                   const std::unique_ptr<Tree>& tree,
-                                                   bool oob_prediction) const {
-  std::vector<bool> valid_samples(num_samples, true);
-  if (oob_prediction) {
-    for (size_t sample : tree->get_drawn_samples()) {
-      valid_samples[sample] = false;
-    }
-  }
-  return valid_samples;
+void TreeTraverser::regenerate_drawn_samples(const Forest& forest,
+                                             size_t num_samples,
+                                             const std::unique_ptr<Tree>& tree,
+                                             std::vector<bool>& drawn) const {
+  drawn.assign(num_samples, false);
+  forest.get_drawn_sample_regenerator()->regenerate(tree->get_drawn_samples_seed(),
+                                                    tree->get_drawn_samples_index(),
+                                                    num_samples,
+                                                    drawn);
 }
 
 } // namespace grf
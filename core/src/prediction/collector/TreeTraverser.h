@@ -19,9 +19,17 @@
 #define GRF_TREETRAVERSER_H
 
 #include "forest/Forest.h"
+#include "prediction/collector/LeafAssignments.h"
+#include "prediction/collector/ValidTreesBySample.h"
 
 namespace grf {
 
+/**
+ * Finds the leaf nodes that samples fall into across the trees of a forest.
+ *
+ * Forests whose trees all have at most 64 leaves are scored with QuickScorer, and deeper
+ * forests are traversed tree by tree. Both give the same leaf nodes.
+ */
 class TreeTraverser {
 public:
   TreeTraverser(uint num_threads);
@@ -31,21 +39,61 @@ public:
       const Data& data,
       bool oob_prediction) const;
 
-  std::vector<std::vector<bool>> get_valid_trees_by_sample(const Forest& forest,
-                                                           const Data& data,
-                                                           bool oob_prediction) const;
+  ValidTreesBySample get_valid_trees_by_sample(const Forest& forest,
+                                               const Data& data,
+                                               bool oob_prediction) const;
+
+  /**
+   * Computes both the leaf nodes and the valid trees of each sample, with leaf nodes
+   * stored compactly so they can be kept around and reused across predictions.
+   */
+  LeafAssignments get_leaf_assignments(const Forest& forest,
+                                       const Data& data,
+                                       bool oob_prediction) const;
 
 private:
-  std::vector<std::vector<size_t>> get_leaf_node_batch(
+  /**
+   * The number of trees traversed together against each tile of samples.
+   */
+  static const size_t TREE_BLOCK_SIZE = 16;
+
+  /**
+   * The number of samples whose features are gathered into each tile.
+   */
+  static const size_t TILE_SIZE = 64;
+
+  template<typename Node>
+  std::vector<std::vector<Node>> collect_leaf_nodes(
+      const Forest& forest,
+      const Data& data,
+      bool oob_prediction) const;
+
+  /**
+   * Scores every sample with QuickScorer. For OOB prediction, the leaf nodes of samples
+   * drawn for a tree are then reset to 0, as traversal leaves them.
+   */
+  template<typename Node>
+  std::vector<std::vector<Node>> score_leaf_nodes(
+      const Forest& forest,
+      const Data& data,
+      bool oob_prediction) const;
+
+  template<typename Node>
+  std::vector<std::vector<Node>> get_leaf_node_batch(
       size_t start,
       size_t num_trees,
       const Forest& forest,
       const Data& data,
       bool oob_prediction) const;
 
-  std::vector<bool> get_valid_samples(size_t num_samples,
-                                      const std::unique_ptr<Tree>& tree,
-                                      bool oob_prediction) const;
+  /**
+   * Fills drawn with a bitmap of the samples drawn for a tree that no longer stores
+   * them, regenerating them from the tree's seed.
+   */
+  void regenerate_drawn_samples(const Forest& forest,
+                                size_t num_samples,
+                                const std::unique_ptr<Tree>& tree,
+                                std::vector<bool>& drawn) const;
 
   uint num_threads;
 };
@@ -0,0 +1,57 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include "prediction/collector/ValidTreesBySample.h"
+
+namespace grf {
+
+ValidTreesBySample::ValidTreesBySample(size_t num_samples,
+                                       size_t num_trees) :
+    num_trees(num_trees),
+    words_per_sample(0) {}
+
+ValidTreesBySample::ValidTreesBySample(size_t num_samples,
+                                       size_t num_trees,
+                                       bool track_invalid_trees) :
+    num_trees(num_trees),
+    words_per_sample(0) {
+  if (!track_invalid_trees) {
+    return;
+  }
+
+  words_per_sample = (num_trees + 63) / 64;
+  std::vector<uint64_t> row(words_per_sample, ~uint64_t(0));
+  // Clear the padding bits past the last tree, so that scans stop at num_trees.
+  if (num_trees % 64 != 0) {
+    row.back() = (uint64_t(1) << (num_trees % 64)) - 1;
+  }
+
+  bits.reserve(num_samples * words_per_sample);
+  for (size_t sample = 0; sample < num_samples; ++sample) {
+    bits.insert(bits.end(), row.begin(), row.end());
+  }
+}
+
+void ValidTreesBySample::set_invalid(size_t sample, size_t tree) {
+  bits[sample * words_per_sample + tree / 64] &= ~(uint64_t(1) << (tree % 64));
+}
+
+size_t ValidTreesBySample::get_num_trees() const {
+  return num_trees;
+}
+
+} // namespace grf
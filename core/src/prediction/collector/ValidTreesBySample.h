@@ -0,0 +1,101 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_VALIDTREESBYSAMPLE_H
+#define GRF_VALIDTREESBYSAMPLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "commons/utility.h"
+
+namespace grf {
+
+/**
+ * Records, for each sample, which trees may be used to predict for it.
+ *
+ * Outside of OOB prediction every tree is valid for every sample, and nothing is
+ * stored. Otherwise validity is kept as a packed bit matrix with one row of
+ * 64-bit words per sample, so that the valid trees of a sample can be scanned a
+ * word at a time.
+ */
+class ValidTreesBySample {
+public:
+  /**
+   * Creates a record in which every tree is valid for every sample.
+   */
+  ValidTreesBySample(size_t num_samples,
+                     size_t num_trees);
+
+  /**
+   * Creates a record in which every tree is valid for every sample, backed by a bit
+   * matrix so that individual trees can then be marked invalid.
+   */
+  ValidTreesBySample(size_t num_samples,
+                     size_t num_trees,
+                     bool track_invalid_trees);
+
+  void set_invalid(size_t sample, size_t tree);
+
+  bool is_valid(size_t sample, size_t tree) const;
+
+  /**
+   * The first tree no smaller than the given tree that is valid for the sample,
+   * or the number of trees if there is none. Iterating over the valid trees of a
+   * sample therefore looks like:
+   *
+   *   for (size_t tree = valid.next(sample, 0); tree < num_trees; tree = valid.next(sample, tree + 1))
+   */
+  size_t next(size_t sample, size_t tree) const;
+
+  size_t get_num_trees() const;
+
+private:
+  size_t num_trees;
+  size_t words_per_sample;
+  std::vector<uint64_t> bits;
+};
+
+// inline the accessors used in the prediction hot loops
+inline bool ValidTreesBySample::is_valid(size_t sample, size_t tree) const {
+  if (bits.empty()) {
+    return true;
+  }
+  return (bits[sample * words_per_sample + tree / 64] >> (tree % 64)) & 1;
+}
+
+inline size_t ValidTreesBySample::next(size_t sample, size_t tree) const {
+  if (bits.empty() || tree >= num_trees) {
+    return tree < num_trees ? tree : num_trees;
+  }
+
+  const uint64_t* row = bits.data() + sample * words_per_sample;
+  size_t word = tree / 64;
+  uint64_t remaining = row[word] & (~uint64_t(0) << (tree % 64));
+  while (remaining == 0) {
+    if (++word == words_per_sample) {
+      return num_trees;
+    }
+    remaining = row[word];
+  }
+  return word * 64 + count_trailing_zeros(remaining);
+}
+
+} // namespace grf
+
+#endif //GRF_VALIDTREESBYSAMPLE_H
@@ -0,0 +1,70 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include "sampling/DrawnSampleRegenerator.h"
+
+namespace grf {
+
+DrawnSampleRegenerator::DrawnSampleRegenerator(const SamplingOptions& options,
+                                               double sample_fraction,
+                                               size_t ci_group_size) :
+    options(options),
+    sample_fraction(sample_fraction),
+    ci_group_size(ci_group_size) {}
+
+std::vector<std::vector<size_t>> DrawnSampleRegenerator::draw_group_clusters(RandomSampler& sampler,
+                                                                             size_t num_rows,
+                                                                             double sample_fraction,
+                                                                             size_t ci_group_size,
+                                                                             size_t num_trees) {
+  std::vector<std::vector<size_t>> clusters_by_tree(num_trees);
+  if (ci_group_size == 1) {
+    sampler.sample_clusters(num_rows, sample_fraction, clusters_by_tree[0]);
+    return clusters_by_tree;
+  }
+
+  // Each tree in a ci group is grown on a subsample of the same half-sample.
+  std::vector<size_t> clusters;
+  sampler.sample_clusters(num_rows, 0.5, clusters);
+  for (size_t i = 0; i < num_trees; ++i) {
+    sampler.subsample(clusters, sample_fraction * 2, clusters_by_tree[i]);
+  }
+  return clusters_by_tree;
+}
+
+void DrawnSampleRegenerator::regenerate(uint group_seed,
+                                        size_t index_in_group,
+                                        size_t num_samples,
+                                        std::vector<bool>& drawn) const {
+  RandomSampler sampler(group_seed, options);
+  std::vector<std::vector<size_t>> clusters_by_tree = draw_group_clusters(
+      sampler, num_samples, sample_fraction, ci_group_size, index_in_group + 1);
+
+  // Stream the drawn samples straight into the bitmap rather than expanding the clusters.
+  const std::vector<std::vector<size_t>>& samples_by_cluster = options.get_clusters();
+  for (size_t cluster : clusters_by_tree[index_in_group]) {
+    if (samples_by_cluster.empty()) {
+      drawn[cluster] = true;
+    } else {
+      for (size_t sample : samples_by_cluster[cluster]) {
+        drawn[sample] = true;
+      }
+    }
+  }
+}
+
+} // namespace grf
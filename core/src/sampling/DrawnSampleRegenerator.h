@@ -0,0 +1,78 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_DRAWNSAMPLEREGENERATOR_H
+#define GRF_DRAWNSAMPLEREGENERATOR_H
+
+#include <vector>
+
+#include "commons/globals.h"
+#include "sampling/RandomSampler.h"
+#include "sampling/SamplingOptions.h"
+
+namespace grf {
+
+/**
+ * Recreates the set of samples drawn for a tree from its group's seed, so that
+ * forests do not need to store each tree's drawn samples to make OOB predictions.
+ *
+ * This relies on ForestTrainer drawing every tree's clusters through
+ * DrawnSampleRegenerator::draw_group_clusters before any tree in the group is grown.
+ */
+class DrawnSampleRegenerator {
+public:
+  DrawnSampleRegenerator(const SamplingOptions& options,
+                         double sample_fraction,
+                         size_t ci_group_size);
+
+  /**
+   * Draws the clusters used to grow the first num_trees trees of a ci group.
+   *
+   * @param sampler: the sampler for this group, which must not have been used yet.
+   * @param num_rows: the number of rows in the training data.
+   * @param sample_fraction: the fraction of clusters each tree is grown on.
+   * @param ci_group_size: the number of trees in the group.
+   * @param num_trees: the number of trees to draw clusters for, at most ci_group_size.
+   */
+  static std::vector<std::vector<size_t>> draw_group_clusters(RandomSampler& sampler,
+                                                              size_t num_rows,
+                                                              double sample_fraction,
+                                                              size_t ci_group_size,
+                                                              size_t num_trees);
+
+  /**
+   * Marks the samples that were drawn for a tree as 'true' in the given bitmap.
+   *
+   * @param group_seed: the seed of the tree's ci group.
+   * @param index_in_group: the index of the tree within its group.
+   * @param num_samples: the number of rows in the training data.
+   * @param drawn: a bitmap of length num_samples, in which the drawn samples are set.
+   */
+  void regenerate(uint group_seed,
+                  size_t index_in_group,
+                  size_t num_samples,
+                  std::vector<bool>& drawn) const;
+
+private:
+  SamplingOptions options;
+  double sample_fraction;
+  size_t ci_group_size;
+};
+
+} // namespace grf
+
+#endif //GRF_DRAWNSAMPLEREGENERATOR_H
@@ -199,4 +199,15 @@ size_t RandomSampler::sample_poisson(size_t mean) {
   return distribution(random_number_generator);
 }
 
+uint RandomSampler::get_group_seed(uint seed, size_t group) {
+  // Key the counter with the forest seed, then apply the SplitMix64 finalizer
+  // to the (key, counter) pair. Consecutive groups map to unrelated seeds.
+  uint64_t state = (static_cast<uint64_t>(seed) << 32) ^ static_cast<uint64_t>(group);
+  state += 0x9E3779B97F4A7C15ULL;
+  state = (state ^ (state >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  state = (state ^ (state >> 27)) * 0x94D049BB133111EBULL;
+  state = state ^ (state >> 31);
+  return static_cast<uint>(state ^ (state >> 32));
+}
+
 } // namespace grf
@@ -26,6 +26,7 @@
 #include "random/algorithm.hpp"
 
 #include <cstddef>
+#include <cstdint>
 #include <random>
 #include <set>
 #include <vector>
@@ -103,6 +104,18 @@ public:
 
   size_t sample_poisson(size_t mean);
 
+  /**
+   * Derives the seed for a single tree group from the forest-level seed.
+   *
+   * The derived seed is a SplitMix64 hash of (seed, group), so it depends only on
+   * the group's index in the forest and not on which thread, batch, or process
+   * happens to train it. This makes the trained forest independent of num_threads.
+   *
+   * @param seed The forest-level random seed.
+   * @param group The index of the tree group (a single tree when ci_group_size is 1).
+   */
+  static uint get_group_seed(uint seed, size_t group);
+
 private:
  /**
   * Create numbers from 0 to n_all-1, then shuffle and select the first 'size' elements.
@@ -0,0 +1,101 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <limits>
+
+#include "tree/CompressedSampleLists.h"
+
+namespace grf {
+
+CompressedSampleLists::CompressedSampleLists() :
+    offsets(1, 0) {}
+
+CompressedSampleLists::CompressedSampleLists(const std::vector<std::vector<size_t>>& lists) {
+  size_t total_size = 0;
+  bool use_wide_ids = false;
+  for (const auto& list : lists) {
+    total_size += list.size();
+    for (size_t sample : list) {
+      use_wide_ids = use_wide_ids || sample > std::numeric_limits<uint32_t>::max();
+    }
+  }
+
+  offsets.reserve(lists.size() + 1);
+  offsets.push_back(0);
+  if (use_wide_ids) {
+    wide_ids.reserve(total_size);
+  } else {
+    narrow_ids.reserve(total_size);
+  }
+
+  for (const auto& list : lists) {
+    append(list, use_wide_ids);
+  }
+}
+
+CompressedSampleLists::CompressedSampleLists(const std::vector<size_t>& list) :
+    offsets(1, 0) {
+  bool use_wide_ids = false;
+  for (size_t sample : list) {
+    use_wide_ids = use_wide_ids || sample > std::numeric_limits<uint32_t>::max();
+  }
+  append(list, use_wide_ids);
+}
+
+size_t CompressedSampleLists::size() const {
+  return offsets.size() - 1;
+}
+
+SampleSpan CompressedSampleLists::get(size_t index) const {
+  size_t start = offsets[index];
+  size_t length = offsets[index + 1] - start;
+  if (length == 0) {
+    return SampleSpan();
+  } else if (wide_ids.empty()) {
+    return SampleSpan(narrow_ids.data() + start, length);
+  } else {
+    return SampleSpan(wide_ids.data() + start, length);
+  }
+}
+
+std::vector<std::vector<size_t>> CompressedSampleLists::to_vectors() const {
+  std::vector<std::vector<size_t>> lists(size());
+  for (size_t i = 0; i < lists.size(); i++) {
+    lists[i] = get(i).to_vector();
+  }
+  return lists;
+}
+
+size_t CompressedSampleLists::estimate_memory_usage() const {
+  return offsets.capacity() * sizeof(size_t)
+      + narrow_ids.capacity() * sizeof(uint32_t)
+      + wide_ids.capacity() * sizeof(uint64_t);
+}
+
+void CompressedSampleLists::append(const std::vector<size_t>& list, bool use_wide_ids) {
+  if (use_wide_ids) {
+    wide_ids.insert(wide_ids.end(), list.begin(), list.end());
+    offsets.push_back(wide_ids.size());
+  } else {
+    for (size_t sample : list) {
+      narrow_ids.push_back(static_cast<uint32_t>(sample));
+    }
+    offsets.push_back(narrow_ids.size());
+  }
+}
+
+} // namespace grf
@@ -0,0 +1,46 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include "tree/SampleSpan.h"
+
+namespace grf {
+
+size_t SampleSpan::lower_bound(size_t sample) const {
+  size_t first = 0;
+  size_t count = length;
+  while (count > 0) {
+    size_t step = count / 2;
+    if ((*this)[first + step] < sample) {
+      first += step + 1;
+      count -= step + 1;
+    } else {
+      count = step;
+    }
+  }
+  return first;
+}
+
+std::vector<size_t> SampleSpan::to_vector() const {
+  std::vector<size_t> samples;
+  samples.reserve(length);
+  for (size_t sample : *this) {
+    samples.push_back(sample);
+  }
+  return samples;
+}
+
+} // namespace grf
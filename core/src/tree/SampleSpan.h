@@ -0,0 +1,135 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_SAMPLESPAN_H_
+#define GRF_SAMPLESPAN_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace grf {
+
+/**
+ * A read-only view over a contiguous run of sample IDs, as stored in
+ * CompressedSampleLists. The IDs may be stored with either 32 or 64 bits,
+ * but are always read back as size_t. The view does not own its data, and is
+ * only valid as long as the lists it was taken from are not modified.
+ */
+class SampleSpan {
+public:
+  class const_iterator {
+  public:
+    const_iterator(const uint32_t* narrow, const uint64_t* wide, size_t index);
+
+    size_t operator*() const;
+    const_iterator& operator++();
+    bool operator==(const const_iterator& other) const;
+    bool operator!=(const const_iterator& other) const;
+
+  private:
+    const uint32_t* narrow;
+    const uint64_t* wide;
+    size_t index;
+  };
+
+  SampleSpan();
+
+  SampleSpan(const uint32_t* narrow, size_t size);
+
+  SampleSpan(const uint64_t* wide, size_t size);
+
+  size_t size() const;
+
+  bool empty() const;
+
+  size_t operator[](size_t index) const;
+
+  const_iterator begin() const;
+
+  const_iterator end() const;
+
+  /**
+   * For a view over sorted sample IDs, the index of the first ID that is not less
+   * than the given sample.
+   */
+  size_t lower_bound(size_t sample) const;
+
+  /**
+   * Copies the sample IDs in this view into a new vector.
+   */
+  std::vector<size_t> to_vector() const;
+
+private:
+  const uint32_t* narrow;
+  const uint64_t* wide;
+  size_t length;
+};
+
+// inline the accessors used in the prediction hot loops
+inline SampleSpan::const_iterator::const_iterator(const uint32_t* narrow, const uint64_t* wide, size_t index) :
+    narrow(narrow), wide(wide), index(index) {}
+
+inline size_t SampleSpan::const_iterator::operator*() const {
+  return narrow != nullptr ? narrow[index] : static_cast<size_t>(wide[index]);
+}
+
+inline SampleSpan::const_iterator& SampleSpan::const_iterator::operator++() {
+  ++index;
+  return *this;
+}
+
+inline bool SampleSpan::const_iterator::operator==(const const_iterator& other) const {
+  return index == other.index;
+}
+
+inline bool SampleSpan::const_iterator::operator!=(const const_iterator& other) const {
+  return index != other.index;
+}
+
+inline SampleSpan::SampleSpan() :
+    narrow(nullptr), wide(nullptr), length(0) {}
+
+inline SampleSpan::SampleSpan(const uint32_t* narrow, size_t size) :
+    narrow(narrow), wide(nullptr), length(size) {}
+
+inline SampleSpan::SampleSpan(const uint64_t* wide, size_t size) :
+    narrow(nullptr), wide(wide), length(size) {}
+
+inline size_t SampleSpan::size() const {
+  return length;
+}
+
+inline bool SampleSpan::empty() const {
+  return length == 0;
+}
+
+inline size_t SampleSpan::operator[](size_t index) const {
+  return narrow != nullptr ? narrow[index] : static_cast<size_t>(wide[index]);
+}
+
+inline SampleSpan::const_iterator SampleSpan::begin() const {
+  return const_iterator(narrow, wide, 0);
+}
+
+inline SampleSpan::const_iterator SampleSpan::end() const {
+  return const_iterator(narrow, wide, length);
+}
+
+} // namespace grf
+
+#endif /* GRF_SAMPLESPAN_H_ */
@@ -15,7 +15,11 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
+#include <algorithm>
 #include <iterator>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
 #include "sampling/RandomSampler.h"
 
 #include "tree/Tree.h"
@@ -32,39 +36,132 @@ Tree::Tree(size_t root_node,
            const std::vector<bool>& send_missing_left,
            const PredictionValues& prediction_values) :
     root_node(root_node),
-    child_nodes(child_nodes),
     leaf_samples(leaf_samples),
-    split_vars(split_vars),
-    split_values(split_values),
     drawn_samples(drawn_samples),
-    send_missing_left(send_missing_left),
-    prediction_values(prediction_values) {}
+    drawn_samples_seed(0),
+    drawn_samples_index(0),
+    drawn_samples_seed_recorded(false),
+    prediction_values(prediction_values) {
+  size_t num_nodes = child_nodes[0].size();
+  if (num_nodes > std::numeric_limits<uint32_t>::max()) {
+    throw std::runtime_error("The number of nodes in a tree cannot exceed 2^32 - 1.");
+  }
+
+  // Split information may be omitted for trailing leaf nodes, so any node without
+  // an entry keeps the defaults of a leaf.
+  nodes.resize(num_nodes, Node{0, 0, SEND_MISSING_LEFT_BIT, 0.0});
+  for (size_t node = 0; node < num_nodes; node++) {
+    Node& packed = nodes[node];
+    packed.left_child = static_cast<uint32_t>(child_nodes[0][node]);
+    packed.right_child = static_cast<uint32_t>(child_nodes[1][node]);
+    if (node < split_values.size()) {
+      packed.split_value = split_values[node];
+    }
+    if (node < send_missing_left.size() && !send_missing_left[node]) {
+      packed.split_var_and_missing_left = 0;
+    }
+    if (node >= split_vars.size()) {
+      continue;
+    }
+
+    size_t split_var = split_vars[node];
+    if (split_var >= SEND_MISSING_LEFT_BIT) {
+      throw std::runtime_error("The number of split variables cannot exceed 2^31 - 1.");
+    }
+    packed.split_var_and_missing_left |= static_cast<uint32_t>(split_var);
+  }
+}
 
 size_t Tree::get_root_node() const {
   return root_node;
 }
 
-const std::vector<std::vector<size_t>>& Tree::get_child_nodes() const {
+std::vector<std::vector<size_t>> Tree::get_child_nodes() const {
+  std::vector<std::vector<size_t>> child_nodes(2, std::vector<size_t>(nodes.size()));
+  for (size_t node = 0; node < nodes.size(); node++) {
+    child_nodes[0][node] = nodes[node].left_child;
+    child_nodes[1][node] = nodes[node].right_child;
+  }
   return child_nodes;
 }
 
-const std::vector<std::vector<size_t>>& Tree::get_leaf_samples() const {
-  return leaf_samples;
+size_t Tree::get_left_child(size_t node) const {
+  return nodes[node].left_child;
+}
+
+size_t Tree::get_right_child(size_t node) const {
+  return nodes[node].right_child;
+}
+
+size_t Tree::get_split_var(size_t node) const {
+  return nodes[node].split_var_and_missing_left & ~SEND_MISSING_LEFT_BIT;
 }
 
-const std::vector<size_t>& Tree::get_split_vars() const  {
+double Tree::get_split_value(size_t node) const {
+  return nodes[node].split_value;
+}
+
+size_t Tree::get_num_nodes() const {
+  return nodes.size();
+}
+
+std::vector<std::vector<size_t>> Tree::get_leaf_samples() const {
+  return leaf_samples.to_vectors();
+}
+
+SampleSpan Tree::get_leaf_samples(size_t node) const {
+  return leaf_samples.get(node);
+}
+
+bool Tree::has_leaf_samples() const {
+  return leaf_samples.size() > 0;
+}
+
+std::vector<size_t> Tree::get_split_vars() const  {
+  std::vector<size_t> split_vars(nodes.size());
+  for (size_t node = 0; node < nodes.size(); node++) {
+    split_vars[node] = get_split_var(node);
+  }
   return split_vars;
 }
 
-const std::vector<double>& Tree::get_split_values() const  {
+std::vector<double> Tree::get_split_values() const  {
+  std::vector<double> split_values(nodes.size());
+  for (size_t node = 0; node < nodes.size(); node++) {
+    split_values[node] = nodes[node].split_value;
+  }
   return split_values;
 }
 
-const std::vector<size_t>& Tree::get_drawn_samples() const  {
-  return drawn_samples;
+SampleSpan Tree::get_drawn_samples() const  {
+  return has_drawn_samples() ? drawn_samples.get(0) : SampleSpan();
 }
 
-const std::vector<bool>& Tree::get_send_missing_left() const  {
+bool Tree::has_drawn_samples() const {
+  return drawn_samples.size() > 0;
+}
+
+uint Tree::get_drawn_samples_seed() const {
+  return drawn_samples_seed;
+}
+
+size_t Tree::get_drawn_samples_index() const {
+  return drawn_samples_index;
+}
+
+bool Tree::has_drawn_samples_seed() const {
+  return drawn_samples_seed_recorded;
+}
+
+bool Tree::get_send_missing_left(size_t node) const {
+  return (nodes[node].split_var_and_missing_left & SEND_MISSING_LEFT_BIT) != 0;
+}
+
+std::vector<bool> Tree::get_send_missing_left() const  {
+  std::vector<bool> send_missing_left(nodes.size());
+  for (size_t node = 0; node < nodes.size(); node++) {
+    send_missing_left[node] = (nodes[node].split_var_and_missing_left & SEND_MISSING_LEFT_BIT) != 0;
+  }
   return send_missing_left;
 }
 
@@ -102,74 +199,207 @@ std::vector<size_t> Tree::find_leaf_nodes(const Data& data,
   return prediction_leaf_nodes;
 }
 
+size_t Tree::estimate_memory_usage() const {
+  size_t memory = sizeof(Tree);
+  memory += nodes.capacity() * sizeof(Node);
+  memory += leaf_samples.estimate_memory_usage();
+  memory += drawn_samples.estimate_memory_usage();
+
+  memory += prediction_values.estimate_memory_usage();
+  return memory;
+}
+
 void Tree::set_leaf_samples(const std::vector<std::vector<size_t>>& leaf_samples) {
-  this->leaf_samples = leaf_samples;
+  this->leaf_samples = CompressedSampleLists(leaf_samples);
 }
 
 void Tree::set_prediction_values(const PredictionValues& prediction_values) {
   this->prediction_values = prediction_values;
 }
 
+void Tree::set_drawn_samples_seed(uint seed, size_t index_in_group) {
+  this->drawn_samples_seed = seed;
+  this->drawn_samples_index = index_in_group;
+  this->drawn_samples_seed_recorded = true;
+}
+
+void Tree::discard_drawn_samples() {
+  drawn_samples = CompressedSampleLists();
+}
+
+void Tree::discard_leaf_samples() {
+  leaf_samples = CompressedSampleLists();
+}
+
+
+void Tree::find_leaf_nodes(const double* tile,
+                           size_t tile_width,
+                           const std::vector<size_t>& column_by_var,
+                           const std::vector<size_t>& tile_samples,
+                           std::vector<size_t>& leaf_nodes) const {
+  leaf_nodes.assign(tile_samples.size(), root_node);
+
+  // Indices into tile_samples whose traversal has not yet reached a leaf.
+  std::vector<size_t> active(tile_samples.size());
+  std::iota(active.begin(), active.end(), 0);
+
+  while (!active.empty()) {
+    size_t num_active = 0;
+    for (size_t i : active) {
+      const Node& current = nodes[leaf_nodes[i]];
+      if (current.left_child == 0 && current.right_child == 0) {
+        continue;
+      }
+
+      size_t split_var = current.split_var_and_missing_left & ~SEND_MISSING_LEFT_BIT;
+      double value = tile[tile_samples[i] * tile_width + column_by_var[split_var]];
+      leaf_nodes[i] = descend(current, value);
+      active[num_active++] = i;
+    }
+    active.resize(num_active);
+  }
+}
 
 size_t Tree::find_leaf_node(const Data& data,
                             size_t sample) const  {
   size_t node = root_node;
   while (true) {
+    const Node& current = nodes[node];
+
     // Break if terminal node
-    if (is_leaf(node)) {
+    if (current.left_child == 0 && current.right_child == 0) {
       break;
     }
 
     // Move to child
-    size_t split_var = get_split_vars()[node];
-    double split_val = get_split_values()[node];
-    double value = data.get(sample, split_var);
-    bool send_na_left = get_send_missing_left()[node];
-    if (
-        (value <= split_val) || // ordinary split
-        (send_na_left && std::isnan(value)) || // are we sending NaN left
-        (std::isnan(split_val) && std::isnan(value)) // are we splitting on NaN
-      ) {
-      // Move to left child
-      node = child_nodes[0][node];
-    } else {
-      // Move to right child
-      node = child_nodes[1][node];
-    }
+    size_t split_var = current.split_var_and_missing_left & ~SEND_MISSING_LEFT_BIT;
+    node = descend(current, data.get(sample, split_var));
   }
   return node;
 };
 
+size_t Tree::descend(const Node& node, double value) {
+  double split_val = node.split_value;
+  bool send_na_left = (node.split_var_and_missing_left & SEND_MISSING_LEFT_BIT) != 0;
+  if (
+      (value <= split_val) || // ordinary split
+      (send_na_left && std::isnan(value)) || // are we sending NaN left
+      (std::isnan(split_val) && std::isnan(value)) // are we splitting on NaN
+    ) {
+    // Move to left child
+    return node.left_child;
+  } else {
+    // Move to right child
+    return node.right_child;
+  }
+}
+
 void Tree::honesty_prune_leaves() {
-  size_t num_nodes = leaf_samples.size();
+  size_t num_nodes = nodes.size();
   for (size_t n = num_nodes; n > root_node; n--) {
     size_t node = n - 1;
     if (is_leaf(node)) {
       continue;
     }
 
-    size_t& left_child = child_nodes[0][node];
+    size_t left_child = nodes[node].left_child;
     if (!is_leaf(left_child)) {
       prune_node(left_child);
+      nodes[node].left_child = static_cast<uint32_t>(left_child);
     }
 
-    size_t& right_child = child_nodes[1][node];
+    size_t right_child = nodes[node].right_child;
     if (!is_leaf(right_child)) {
       prune_node(right_child);
+      nodes[node].right_child = static_cast<uint32_t>(right_child);
     }
   }
   prune_node(root_node);
 }
 
+void Tree::compact() {
+  std::vector<size_t> order = get_compacted_order();
+  size_t num_reachable = order.size();
+
+  std::vector<size_t> new_ids(nodes.size(), 0);
+  for (size_t new_id = 0; new_id < num_reachable; ++new_id) {
+    new_ids[order[new_id]] = new_id;
+  }
+
+  std::vector<Node> new_nodes(num_reachable);
+  for (size_t new_id = 0; new_id < num_reachable; ++new_id) {
+    Node node = nodes[order[new_id]];
+    node.left_child = static_cast<uint32_t>(new_ids[node.left_child]);
+    node.right_child = static_cast<uint32_t>(new_ids[node.right_child]);
+    new_nodes[new_id] = node;
+  }
+
+  if (has_leaf_samples()) {
+    std::vector<std::vector<size_t>> new_leaf_samples(num_reachable);
+    for (size_t new_id = 0; new_id < num_reachable; ++new_id) {
+      if (order[new_id] < leaf_samples.size()) {
+        new_leaf_samples[new_id] = leaf_samples.get(order[new_id]).to_vector();
+      }
+    }
+    leaf_samples = CompressedSampleLists(new_leaf_samples);
+  }
+
+  if (prediction_values.get_num_nodes() == nodes.size()) {
+    std::vector<std::vector<double>> new_values(num_reachable);
+    for (size_t new_id = 0; new_id < num_reachable; ++new_id) {
+      new_values[new_id] = prediction_values.get_values(order[new_id]);
+    }
+    prediction_values = PredictionValues(new_values, prediction_values.get_num_types());
+  }
+
+  nodes = std::move(new_nodes);
+  root_node = 0;
+}
+
+std::vector<size_t> Tree::get_compacted_order() const {
+  std::vector<size_t> order;
+  order.reserve(nodes.size());
+
+  // Lay out the top levels breadth-first.
+  std::vector<size_t> level = {root_node};
+  for (size_t depth = 0; depth < BREADTH_FIRST_DEPTH && !level.empty(); ++depth) {
+    std::vector<size_t> next_level;
+    for (size_t node : level) {
+      order.push_back(node);
+      if (!is_leaf(node)) {
+        next_level.push_back(nodes[node].left_child);
+        next_level.push_back(nodes[node].right_child);
+      }
+    }
+    level = next_level;
+  }
+
+  // Then lay out each remaining subtree depth-first, visiting left children first.
+  std::vector<size_t> stack;
+  for (size_t subtree_root : level) {
+    stack.push_back(subtree_root);
+    while (!stack.empty()) {
+      size_t node = stack.back();
+      stack.pop_back();
+      order.push_back(node);
+      if (!is_leaf(node)) {
+        stack.push_back(nodes[node].right_child);
+        stack.push_back(nodes[node].left_child);
+      }
+    }
+  }
+  return order;
+}
+
 void Tree::prune_node(size_t& node) {
-  size_t left_child = child_nodes[0][node];
-  size_t right_child = child_nodes[1][node];
+  size_t left_child = nodes[node].left_child;
+  size_t right_child = nodes[node].right_child;
 
   // If either child is empty, prune this node.
   if (is_empty_leaf(left_child) || is_empty_leaf(right_child)) {
     // Empty out this node.
-    child_nodes[0][node] = 0;
-    child_nodes[1][node] = 0;
+    nodes[node].left_child = 0;
+    nodes[node].right_child = 0;
 
     // If one of the children is not empty, promote it.
     if (!is_empty_leaf(left_child)) {
@@ -181,11 +411,11 @@ void Tree::prune_node(size_t& node) {
 }
 
 bool Tree::is_leaf(size_t node) const  {
-  return child_nodes[0][node] == 0 && child_nodes[1][node] == 0;
+  return nodes[node].left_child == 0 && nodes[node].right_child == 0;
 }
 
 bool Tree::is_empty_leaf(size_t node) const  {
-  return is_leaf(node) && leaf_samples[node].empty();
+  return is_leaf(node) && (node >= leaf_samples.size() || leaf_samples.get(node).empty());
 }
 
 } // namespace grf
@@ -18,6 +18,7 @@
 #ifndef GRF_TREE_H_
 #define GRF_TREE_H_
 
+#include <cstdint>
 #include <vector>
 
 #include "commons/globals.h"
@@ -25,11 +26,17 @@
 #include "sampling/RandomSampler.h"
 #include "prediction/PredictionValues.h"
 #include "splitting/SplittingRule.h"
+#include "tree/CompressedSampleLists.h"
+#include "tree/SampleSpan.h"
 
 namespace grf {
 
 class Tree {
 public:
+  /**
+   * The drawn samples must be sorted in increasing order. They are sorted once when a
+   * tree is trained, so that constructing a tree does no work beyond copying its fields.
+   */
   Tree(size_t root_node,
        const std::vector<std::vector<size_t>>& child_nodes,
        const std::vector<std::vector<size_t>>& leaf_samples,
@@ -66,6 +73,29 @@ public:
    */
   std::vector<size_t> find_leaf_nodes(const Data& data,
                                       const std::vector<bool>& valid_samples) const;
+
+  /**
+   * Finds the leaf nodes for a tile of samples whose features have been gathered
+   * into a row-major buffer. The traversals of all samples are interleaved level
+   * by level, so that the memory accesses of different samples overlap.
+   *
+   * @param tile: the gathered features, with one row of tile_width values per sample.
+   * @param tile_width: the number of values stored for each sample in the tile.
+   * @param column_by_var: for each variable this tree splits on, its column in the tile.
+   * @param tile_samples: the rows of the tile whose leaf nodes should be calculated.
+   * @param leaf_nodes: the resulting node ID for each entry of tile_samples.
+   */
+  void find_leaf_nodes(const double* tile,
+                       size_t tile_width,
+                       const std::vector<size_t>& column_by_var,
+                       const std::vector<size_t>& tile_samples,
+                       std::vector<size_t>& leaf_nodes) const;
+
+  /**
+   * Recurses down the tree to find the leaf node ID that a single sample belongs in.
+   */
+  size_t find_leaf_node(const Data& data,
+                        size_t sample) const;
   /**
    * Removes all empty leaf nodes.
    *
@@ -75,6 +105,17 @@ public:
    */
   void honesty_prune_leaves();
 
+  /**
+   * Drops all nodes that are no longer reachable from the root (for example after
+   * pruning), and renumbers the remaining nodes so that traversals touch memory in
+   * order: the top levels of the tree are laid out breadth-first, since every
+   * traversal passes through them, and the subtrees below are each laid out
+   * depth-first so a left descent reads the next node.
+   *
+   * After compaction the root node is always 0. Predictions are unaffected.
+   */
+  void compact();
+
   /**
    * The ID of the root node for this tree. Note that this is usually 0, but may not always
    * be as the top of the tree can be pruned.
@@ -85,38 +126,108 @@ public:
    * A vector containing two vectors: the first gives the ID of the left child for every
    * node, and the second gives the ID of the right child. If a node is a leaf, the entries
    * for both the left and right children will be '0'.
+   *
+   * Note that this is assembled from the packed node layout on every call, so
+   * traversal code should prefer the per-node accessors below.
    */
-  const std::vector<std::vector<size_t>>& get_child_nodes() const;
+  std::vector<std::vector<size_t>> get_child_nodes() const;
+
+  /**
+   * The ID of the left child of the given node, or '0' if the node is a leaf.
+   */
+  size_t get_left_child(size_t node) const;
+
+  /**
+   * The ID of the right child of the given node, or '0' if the node is a leaf.
+   */
+  size_t get_right_child(size_t node) const;
+
+  /**
+   * The ID of the variable the given node splits on.
+   */
+  size_t get_split_var(size_t node) const;
+
+  /**
+   * The value the given node splits on.
+   */
+  double get_split_value(size_t node) const;
+
+  /**
+   * The number of nodes in this tree, including pruned nodes.
+   */
+  size_t get_num_nodes() const;
 
   /**
    * Specifies the samples that each node contains. Note that only leaf nodes will contain
    * a non-empty vector of sample IDs.
+   *
+   * Note that this copies the samples out of the compressed storage, so prediction
+   * code should prefer the per-node view below.
+   */
+  std::vector<std::vector<size_t>> get_leaf_samples() const;
+
+  /**
+   * A view of the samples contained in the given node.
    */
-  const std::vector<std::vector<size_t>>& get_leaf_samples() const;
+  SampleSpan get_leaf_samples(size_t node) const;
+
+  /**
+   * Whether this tree still stores the samples in each leaf. Trees trained without
+   * keeping their leaf samples only support optimized predictions.
+   */
+  bool has_leaf_samples() const;
 
   /**
    * For each split, the ID of the variable that was chosen to split on.
    */
-  const std::vector<size_t>& get_split_vars() const;
+  std::vector<size_t> get_split_vars() const;
 
   /**
    * For each split, the value of the variable that was chosen to split on.
    */
-  const std::vector<double>& get_split_values() const;
+  std::vector<double> get_split_values() const;
 
   /**
    * The sample IDs that were not drawn in creating this tree. For honest trees,
    * this excludes both samples that went into growing the tree, as well as samples
-   * used to repopulate the leaves.
+   * used to repopulate the leaves. The IDs are sorted in increasing order.
    */
-  const std::vector<size_t>& get_drawn_samples() const;
+  SampleSpan get_drawn_samples() const;
+
+  /**
+   * Whether this tree still stores its drawn samples. If not, they can be
+   * regenerated from the drawn samples seed through a DrawnSampleRegenerator.
+   */
+  bool has_drawn_samples() const;
+
+  /**
+   * The seed of the ci group this tree was grown in, from which its drawn samples
+   * can be regenerated.
+   */
+  uint get_drawn_samples_seed() const;
+
+  /**
+   * The index of this tree within its ci group.
+   */
+  size_t get_drawn_samples_index() const;
+
+  /**
+   * Whether the drawn samples seed was recorded during training. It is not kept by
+   * serialization, so deserialized trees cannot have their drawn samples regenerated.
+   */
+  bool has_drawn_samples_seed() const;
 
   /**
    * The NaN direction for each node. Left: true, Right: false.
    * If a tree is grown without missing values in X, these are all true
    * by default.
    */
-  const std::vector<bool>& get_send_missing_left() const;
+  std::vector<bool> get_send_missing_left() const;
+
+  /**
+   * Whether the given node sends missing values to its left child.
+   */
+  bool get_send_missing_left(size_t node) const;
 
   /**
    * Optional summary values about the samples in each leaf. Note that this will only
@@ -130,6 +241,12 @@ public:
    */
   bool is_leaf(size_t node) const;
 
+  /**
+   * An estimate of the memory (in bytes) used by this tree, including its
+   * leaf samples, drawn samples and prediction values.
+   */
+  size_t estimate_memory_usage() const;
+
   /**
    * Sets the contents of this tree's leaf nodes. Please see
    * Tree::get_leaf_samples for a description of this variable.
@@ -142,19 +259,59 @@ public:
    */
   void set_prediction_values(const PredictionValues& prediction_values);
 
+  /**
+   * Records the seed and group index this tree's drawn samples were sampled with.
+   */
+  void set_drawn_samples_seed(uint seed, size_t index_in_group);
+
+  /**
+   * Frees the stored drawn samples. Afterwards they must be regenerated from
+   * the drawn samples seed.
+   */
+  void discard_drawn_samples();
+
+  /**
+   * Frees the samples stored in each leaf, keeping only the prediction values.
+   */
+  void discard_leaf_samples();
+
 private:
-  size_t find_leaf_node(const Data& data,
-                        size_t sample) const;
+  /**
+   * A node in the packed tree layout: child IDs, the split variable with the NaN
+   * direction stored in its top bit, and the split value, so each traversal step
+   * reads a single 24-byte record instead of five separate arrays.
+   */
+  struct Node {
+    uint32_t left_child;
+    uint32_t right_child;
+    uint32_t split_var_and_missing_left;
+    double split_value;
+  };
+
+  static const uint32_t SEND_MISSING_LEFT_BIT = 0x80000000u;
+
+  /**
+   * The number of top levels that compaction lays out breadth-first.
+   */
+  static const size_t BREADTH_FIRST_DEPTH = 4;
+
+  std::vector<size_t> get_compacted_order() const;
+
+  /**
+   * Returns the child of the given node that a sample with this value of the
+   * node's split variable is sent to.
+   */
+  static size_t descend(const Node& node, double value);
   void prune_node(size_t& node);
   bool is_empty_leaf(size_t node) const;
 
   size_t root_node;
-  std::vector<std::vector<size_t>> child_nodes;
-  std::vector<std::vector<size_t>> leaf_samples;
-  std::vector<size_t> split_vars;
-  std::vector<double> split_values;
-  std::vector<size_t> drawn_samples;
-  std::vector<bool> send_missing_left;
+  std::vector<Node> nodes;
+  CompressedSampleLists leaf_samples;
+  CompressedSampleLists drawn_samples;
+  uint drawn_samples_seed;
+  size_t drawn_samples_index;
+  bool drawn_samples_seed_recorded;
 
   PredictionValues prediction_values;
 };
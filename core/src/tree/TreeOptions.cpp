@@ -26,13 +26,25 @@ TreeOptions::TreeOptions(uint mtry,
                          bool honesty_prune_leaves,
                          double alpha,
                          double imbalance_penalty):
+  TreeOptions(mtry, min_node_size, honesty, honesty_fraction, honesty_prune_leaves, alpha,
+              imbalance_penalty, true) {}
+
+TreeOptions::TreeOptions(uint mtry,
+                         uint min_node_size,
+                         bool honesty,
+                         double honesty_fraction,
+                         bool honesty_prune_leaves,
+                         double alpha,
+                         double imbalance_penalty,
+                         bool keep_leaf_samples):
   mtry(mtry),
   min_node_size(min_node_size),
   honesty(honesty),
   honesty_fraction(honesty_fraction),
   honesty_prune_leaves(honesty_prune_leaves),
   alpha(alpha),
-  imbalance_penalty(imbalance_penalty) {}
+  imbalance_penalty(imbalance_penalty),
+  keep_leaf_samples(keep_leaf_samples) {}
 
 uint TreeOptions::get_mtry() const {
   return mtry;
@@ -62,4 +74,8 @@ double TreeOptions::get_imbalance_penalty() const {
   return imbalance_penalty;
 }
 
+bool TreeOptions::get_keep_leaf_samples() const {
+  return keep_leaf_samples;
+}
+
 } // namespace grf
@@ -32,6 +32,15 @@ public:
               double alpha,
               double imbalance_penalty);
 
+  TreeOptions(uint mtry,
+              uint min_node_size,
+              bool honesty,
+              double honesty_fraction,
+              bool honesty_prune_leaves,
+              double alpha,
+              double imbalance_penalty,
+              bool keep_leaf_samples);
+
   uint get_mtry() const;
   uint get_min_node_size() const;
 
@@ -59,6 +68,13 @@ public:
    */
   double get_imbalance_penalty() const;
 
+  /**
+   * Whether trees keep the list of samples in each leaf after training. If false, the
+   * lists are discarded once the optimized prediction values have been computed, so
+   * the forest can only be used for optimized predictions.
+   */
+  bool get_keep_leaf_samples() const;
+
 private:
   uint mtry;
   uint min_node_size;
@@ -67,6 +83,7 @@ private:
   bool honesty_prune_leaves;
   double alpha;
   double imbalance_penalty;
+  bool keep_leaf_samples;
 };
 
 } // namespace grf
@@ -33,7 +33,8 @@ TreeTrainer::TreeTrainer(std::unique_ptr<RelabelingStrategy> relabeling_strategy
 std::unique_ptr<Tree> TreeTrainer::train(const Data& data,
                                          RandomSampler& sampler,
                                          const std::vector<size_t>& clusters,
-                                         const TreeOptions& options) const {
+                                         const TreeOptions& options,
+                                         const TrainingBudget& budget) const {
   std::vector<std::vector<size_t>> child_nodes;
   std::vector<std::vector<size_t>> nodes;
   std::vector<size_t> split_vars;
@@ -65,6 +66,9 @@ std::unique_ptr<Tree> TreeTrainer::train(const Data& data,
   size_t i = 0;
   Eigen::ArrayXXd responses_by_sample(data.get_num_rows(), relabeling_strategy->get_response_length());
   while (num_open_nodes > 0) {
+    if (budget.is_exhausted()) {
+      return nullptr;
+    }
     bool is_leaf_node = split_node(i,
                                    data,
                                    splitting_rule,
@@ -87,6 +91,7 @@ std::unique_ptr<Tree> TreeTrainer::train(const Data& data,
 
   std::vector<size_t> drawn_samples;
   sampler.get_samples_in_clusters(clusters, drawn_samples);
+  std::sort(drawn_samples.begin(), drawn_samples.end());
 
   std::unique_ptr<Tree> tree(new Tree(0, child_nodes, nodes,
       split_vars, split_values, drawn_samples, send_missing_left, PredictionValues()));
@@ -94,6 +99,7 @@ std::unique_ptr<Tree> TreeTrainer::train(const Data& data,
   if (!new_leaf_samples.empty()) {
     repopulate_leaf_nodes(tree, data, new_leaf_samples, options.get_honesty_prune_leaves());
   }
+  tree->compact();
 
   PredictionValues prediction_values;
   if (prediction_strategy != nullptr) {
@@ -101,14 +107,22 @@ std::unique_ptr<Tree> TreeTrainer::train(const Data& data,
   }
   tree->set_prediction_values(prediction_values);
 
+  if (!options.get_keep_leaf_samples()) {
+    tree->discard_leaf_samples();
+  }
+
   return tree;
 }
 
+const OptimizedPredictionStrategy* TreeTrainer::get_prediction_strategy() const {
+  return prediction_strategy.get();
+}
+
 void TreeTrainer::repopulate_leaf_nodes(const std::unique_ptr<Tree>& tree,
                                         const Data& data,
                                         const std::vector<size_t>& leaf_samples,
                                         const bool honesty_prune_leaves) const {
-  size_t num_nodes = tree->get_leaf_samples().size();
+  size_t num_nodes = tree->get_num_nodes();
   std::vector<std::vector<size_t>> new_leaf_nodes(num_nodes);
 
   std::vector<size_t> leaf_nodes = tree->find_leaf_nodes(data, leaf_samples);
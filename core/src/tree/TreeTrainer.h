@@ -22,6 +22,7 @@
 
 #include "Eigen/Dense"
 #include "commons/Data.h"
+#include "forest/TrainingBudget.h"
 #include "prediction/OptimizedPredictionStrategy.h"
 #include "relabeling/RelabelingStrategy.h"
 #include "sampling/RandomSampler.h"
@@ -37,10 +38,21 @@ public:
               std::unique_ptr<SplittingRuleFactory> splitting_rule_factory,
               std::unique_ptr<OptimizedPredictionStrategy> prediction_strategy);
 
+  /**
+   * Grows a single tree. The budget is checked before each node is split, and if it
+   * has run out the partially grown tree is discarded and nullptr is returned.
+   */
   std::unique_ptr<Tree> train(const Data& data,
                               RandomSampler& sampler,
                               const std::vector<size_t>& clusters,
-                              const TreeOptions& options) const;
+                              const TreeOptions& options,
+                              const TrainingBudget& budget) const;
+
+  /**
+   * The strategy used to precompute prediction values in each leaf, or nullptr
+   * if the trees are trained without one.
+   */
+  const OptimizedPredictionStrategy* get_prediction_strategy() const;
 
 private:
   void create_empty_node(std::vector<std::vector<size_t>>& child_nodes,
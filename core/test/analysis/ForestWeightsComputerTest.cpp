@@ -0,0 +1,118 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+
+#include "analysis/ForestWeightsComputer.h"
+#include "commons/utility.h"
+#include "forest/ForestTrainers.h"
+#include "prediction/collector/SampleWeightComputer.h"
+#include "prediction/collector/TreeTraverser.h"
+#include "utilities/ForestTestUtilities.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+void check_matches_sample_weights(const ForestWeights& forest_weights,
+                                  const Forest& forest,
+                                  const Data& train_data,
+                                  const Data& data,
+                                  bool oob_prediction) {
+  TreeTraverser traverser(1);
+  LeafAssignments leaf_assignments = traverser.get_leaf_assignments(forest, data, oob_prediction);
+
+  REQUIRE(forest_weights.get_num_rows() == data.get_num_rows());
+  REQUIRE(forest_weights.get_num_cols() == train_data.get_num_rows());
+
+  SampleWeightComputer weight_computer(train_data.get_num_rows());
+  std::vector<std::pair<size_t, double>> weights;
+  const std::vector<size_t>& row_offsets = forest_weights.get_row_offsets();
+  for (size_t sample = 0; sample < data.get_num_rows(); ++sample) {
+    weight_computer.compute_weights(sample, forest, leaf_assignments, weights);
+    REQUIRE(row_offsets[sample + 1] - row_offsets[sample] == weights.size());
+    for (size_t i = 0; i < weights.size(); ++i) {
+      size_t index = row_offsets[sample] + i;
+      REQUIRE(forest_weights.get_columns()[index] == weights[i].first);
+      REQUIRE(forest_weights.get_values()[index] == weights[i].second);
+    }
+  }
+  REQUIRE(row_offsets.back() == forest_weights.get_num_nonzeros());
+}
+
+TEST_CASE("forest weights match per-sample weights", "[analysis, unit]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  Forest forest = trainer.train(data, ForestTestUtilities::default_honest_options());
+
+  Data test_data(data_vec);
+  test_data.set_outcome_index(10);
+
+  ForestWeightsComputer computer(4);
+  ForestWeights weights = computer.compute(forest, data, test_data, false);
+  check_matches_sample_weights(weights, forest, data, test_data, false);
+
+  ForestWeights oob_weights = computer.compute(forest, data, data, true);
+  check_matches_sample_weights(oob_weights, forest, data, data, true);
+}
+
+TEST_CASE("truncated forest weights keep the largest weights of each row", "[analysis, unit]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  Forest forest = trainer.train(data, ForestTestUtilities::default_honest_options());
+
+  size_t max_weights = 5;
+  ForestWeightsComputer computer(3);
+  ForestWeights full_weights = computer.compute(forest, data, data, true);
+  ForestWeights weights = computer.compute(forest, data, data, true, max_weights);
+
+  const std::vector<size_t>& full_offsets = full_weights.get_row_offsets();
+  const std::vector<size_t>& offsets = weights.get_row_offsets();
+  for (size_t sample = 0; sample < data.get_num_rows(); ++sample) {
+    size_t full_size = full_offsets[sample + 1] - full_offsets[sample];
+    size_t size = offsets[sample + 1] - offsets[sample];
+    REQUIRE(size == std::min(full_size, max_weights));
+
+    std::vector<double> full_values(full_weights.get_values().begin() + full_offsets[sample],
+                                    full_weights.get_values().begin() + full_offsets[sample + 1]);
+    std::sort(full_values.rbegin(), full_values.rend());
+
+    std::vector<double> values(weights.get_values().begin() + offsets[sample],
+                               weights.get_values().begin() + offsets[sample + 1]);
+    std::sort(values.rbegin(), values.rend());
+    for (size_t i = 0; i < size; ++i) {
+      REQUIRE(values[i] == full_values[i]);
+    }
+
+    for (size_t index = offsets[sample] + 1; index < offsets[sample + 1]; ++index) {
+      REQUIRE(weights.get_columns()[index - 1] < weights.get_columns()[index]);
+    }
+  }
+
+  try {
+    computer.compute(forest, data, data, true, 0);
+    FAIL();
+  } catch (const std::runtime_error&) {
+    // Expected exception.
+  }
+}
@@ -0,0 +1,64 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <stdexcept>
+
+#include "analysis/LambdaPathErrorComputer.h"
+#include "commons/utility.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+TEST_CASE("lambda path errors average squared residuals for each lambda", "[analysis, local linear]") {
+  // Outcomes 1, 2, 3 and treatments 2, -1, 0.5, stored column by column.
+  std::vector<double> data_vec = {1.0, 2.0, 3.0,
+                                  2.0, -1.0, 0.5};
+  Data data(data_vec, 3, 2);
+  data.set_outcome_index(0);
+  data.set_treatment_index(1);
+
+  std::vector<Prediction> predictions = {Prediction({1.5, 0.0}),
+                                         Prediction({2.0, NAN}),
+                                         Prediction({4.0, 2.0})};
+  LambdaPathErrorComputer computer;
+
+  std::vector<double> regression_errors = computer.compute_regression_errors(predictions, data);
+  REQUIRE(regression_errors.size() == 2);
+  REQUIRE(equal_doubles((0.25 + 0.0 + 1.0) / 3, regression_errors[0], 1e-12));
+  REQUIRE(equal_doubles((1.0 + 1.0) / 2, regression_errors[1], 1e-12));
+
+  std::vector<double> r_learner_errors = computer.compute_r_learner_errors(predictions, data);
+  REQUIRE(r_learner_errors.size() == 2);
+  REQUIRE(equal_doubles((4.0 + 16.0 + 1.0) / 3, r_learner_errors[0], 1e-12));
+  REQUIRE(equal_doubles((1.0 + 4.0) / 2, r_learner_errors[1], 1e-12));
+}
+
+TEST_CASE("lambda path errors require one prediction per sample", "[analysis, local linear]") {
+  std::vector<double> data_vec = {1.0, 2.0};
+  Data data(data_vec, 2, 1);
+  data.set_outcome_index(0);
+
+  std::vector<Prediction> predictions = {Prediction({1.0})};
+  try {
+    LambdaPathErrorComputer().compute_regression_errors(predictions, data);
+    FAIL();
+  } catch (const std::runtime_error&) {
+    // Expected exception.
+  }
+}
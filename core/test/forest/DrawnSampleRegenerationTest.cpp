@@ -0,0 +1,95 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <stdexcept>
+
+#include "commons/utility.h"
+#include "forest/ForestPredictor.h"
+#include "forest/ForestPredictors.h"
+#include "forest/ForestTrainer.h"
+#include "forest/ForestTrainers.h"
+#include "utilities/ForestTestUtilities.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+TEST_CASE_METHOD(GaussianDataFixture, "OOB predictions are unchanged after discarding drawn samples", "[regression, forest]") {
+  // Assign the samples to clusters to exercise cluster expansion during regeneration.
+  std::vector<size_t> clusters;
+  for (size_t sample = 0; sample < data.get_num_rows(); sample++) {
+    clusters.push_back(sample % 37);
+  }
+
+  for (size_t ci_group_size : {1, 2}) {
+    for (const std::vector<size_t>& sample_clusters : {std::vector<size_t>(), clusters}) {
+      ForestOptions options(50, ci_group_size, 0.35, 3, 1, true, 0.5, true, 0.0, 0.0, 4, 42,
+          sample_clusters, 5);
+      ForestTrainer trainer = regression_trainer();
+      ForestPredictor predictor = regression_predictor(4);
+
+      Forest forest = trainer.train(data, options);
+      std::vector<Prediction> expected = predictor.predict_oob(forest, data, ci_group_size > 1);
+
+      forest.discard_drawn_samples(options);
+      for (const auto& tree : forest.get_trees()) {
+        REQUIRE(!tree->has_drawn_samples());
+      }
+      std::vector<Prediction> actual = predictor.predict_oob(forest, data, ci_group_size > 1);
+
+      REQUIRE(expected.size() == actual.size());
+      for (size_t sample = 0; sample < data.get_num_rows(); sample++) {
+        REQUIRE(equal_doubles(expected[sample].get_predictions()[0], actual[sample].get_predictions()[0], 1e-12));
+        if (ci_group_size > 1) {
+          REQUIRE(equal_doubles(expected[sample].get_variance_estimates()[0],
+                                actual[sample].get_variance_estimates()[0], 1e-12));
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE_METHOD(GaussianDataFixture, "drawn samples cannot be discarded from deserialized trees", "[regression, forest]") {
+  ForestOptions options = ForestTestUtilities::default_options();
+  ForestTrainer trainer = regression_trainer();
+  Forest forest = trainer.train(data, options);
+
+  // Rebuild the trees from their serialized fields, which do not include the sampling seeds.
+  std::vector<std::unique_ptr<Tree>> trees;
+  for (const auto& tree : forest.get_trees()) {
+    trees.emplace_back(new Tree(tree->get_root_node(),
+                                tree->get_child_nodes(),
+                                tree->get_leaf_samples(),
+                                tree->get_split_vars(),
+                                tree->get_split_values(),
+                                tree->get_drawn_samples().to_vector(),
+                                tree->get_send_missing_left(),
+                                tree->get_prediction_values()));
+  }
+  Forest deserialized(trees, forest.get_num_variables(), forest.get_ci_group_size());
+
+  try {
+    deserialized.discard_drawn_samples(options);
+    FAIL();
+  } catch (const std::runtime_error&) {
+    // Expected exception.
+  }
+  for (const auto& tree : deserialized.get_trees()) {
+    REQUIRE(tree->has_drawn_samples());
+  }
+  REQUIRE(deserialized.get_drawn_sample_regenerator() == nullptr);
+}
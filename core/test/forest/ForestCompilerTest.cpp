@@ -0,0 +1,170 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef _WIN32
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <dlfcn.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "commons/utility.h"
+#include "forest/ForestCompilers.h"
+#include "forest/ForestPredictors.h"
+#include "forest/ForestTrainers.h"
+#include "utilities/ForestTestUtilities.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+typedef size_t (*CompiledPredictionLength)();
+typedef void (*CompiledPredict)(const double*, double*);
+
+/**
+ * A directory created with mkdtemp, which is removed along with the given files once
+ * the test is done, even if it fails.
+ */
+class TemporaryDirectory {
+public:
+  TemporaryDirectory(): path("/tmp/grf_compiled_XXXXXX") {
+    std::vector<char> path_template(path.begin(), path.end());
+    path_template.push_back('\0');
+    REQUIRE(mkdtemp(path_template.data()) != nullptr);
+    path = path_template.data();
+  }
+
+  ~TemporaryDirectory() {
+    for (const std::string& file : files) {
+      std::remove(file.c_str());
+    }
+    rmdir(path.c_str());
+  }
+
+  std::string add_file(const std::string& name) {
+    files.push_back(path + "/" + name);
+    return files.back();
+  }
+
+private:
+  std::string path;
+  std::vector<std::string> files;
+};
+
+void check_compiled_forest(const ForestCompiler& compiler,
+                           const Forest& forest,
+                           const ForestPredictor& predictor,
+                           const Data& data) {
+  if (std::system("c++ --version > /dev/null 2>&1") != 0) {
+    WARN("Skipping the compiled forest check, since no C++ compiler is available.");
+    return;
+  }
+
+  TemporaryDirectory directory;
+  std::string source_file = directory.add_file("forest.cpp");
+  std::string library_file = directory.add_file("forest.so");
+  std::ofstream source(source_file);
+  compiler.compile(forest, source);
+  source.close();
+
+  std::string command = "c++ -std=c++11 -O2 -ffp-contract=off -shared -fPIC -o " + library_file + " " + source_file;
+  REQUIRE(std::system(command.c_str()) == 0);
+  void* library = dlopen(library_file.c_str(), RTLD_NOW | RTLD_LOCAL);
+  REQUIRE(library != nullptr);
+  CompiledPredictionLength prediction_length = (CompiledPredictionLength) dlsym(library, "grf_prediction_length");
+  CompiledPredict predict = (CompiledPredict) dlsym(library, "grf_predict");
+  REQUIRE(prediction_length != nullptr);
+  REQUIRE(predict != nullptr);
+
+  std::vector<Prediction> expected = predictor.predict(forest, data, data, false);
+  std::vector<double> row(data.get_num_cols());
+  std::vector<double> actual(prediction_length());
+  REQUIRE(actual.size() == expected[0].size());
+
+  for (size_t sample = 0; sample < data.get_num_rows(); ++sample) {
+    for (size_t col = 0; col < data.get_num_cols(); ++col) {
+      row[col] = data.get(sample, col);
+    }
+    predict(row.data(), actual.data());
+
+    // Predictions must agree bit for bit.
+    const std::vector<double>& expected_values = expected[sample].get_predictions();
+    for (size_t i = 0; i < actual.size(); ++i) {
+      REQUIRE(((std::isnan(expected_values[i]) && std::isnan(actual[i])) || expected_values[i] == actual[i]));
+    }
+  }
+  dlclose(library);
+}
+
+TEST_CASE("compiled regression forests predict exactly as the forest predictor", "[regression, forest]") {
+  auto data_vec = load_data("test/forest/resources/regression_data_MIA.csv");
+  Data data(data_vec);
+  data.set_outcome_index(5);
+
+  ForestTrainer trainer = regression_trainer();
+  Forest forest = trainer.train(data, ForestTestUtilities::default_honest_options());
+
+  check_compiled_forest(regression_compiler(), forest, regression_predictor(4), data);
+}
+
+TEST_CASE("compiled instrumental forests predict exactly as the forest predictor", "[instrumental, forest]") {
+  auto data_vec = load_data("test/forest/resources/causal_data_MIA.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  data.set_treatment_index(11);
+  data.set_instrument_index(11);
+
+  ForestTrainer trainer = instrumental_trainer(0.0, true);
+  Forest forest = trainer.train(data, ForestTestUtilities::default_options());
+
+  check_compiled_forest(instrumental_compiler(), forest, instrumental_predictor(4), data);
+}
+
+TEST_CASE("compiled probability forests predict exactly as the forest predictor", "[probability, forest]") {
+  auto data_vec = load_data("test/forest/resources/probability_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  size_t num_classes = 6;
+
+  ForestTrainer trainer = probability_trainer(num_classes);
+  Forest forest = trainer.train(data, ForestTestUtilities::default_honest_options());
+
+  check_compiled_forest(probability_compiler(num_classes), forest, probability_predictor(4, num_classes),
+                        data);
+}
+
+TEST_CASE("forests without prediction values cannot be compiled", "[regression, forest]") {
+  // A single leaf tree, as built by a trainer with a default prediction strategy.
+  std::vector<std::unique_ptr<Tree>> trees;
+  trees.emplace_back(new Tree(0, {{0}, {0}}, {{0, 1, 2}}, {0}, {0}, {}, {true}, PredictionValues()));
+  Forest forest(trees, 5, 1);
+
+  std::ostringstream source;
+  try {
+    regression_compiler().compile(forest, source);
+    FAIL();
+  } catch (const std::runtime_error&) {
+    // Expected exception.
+  }
+}
+
+#endif
@@ -109,3 +109,42 @@ TEST_CASE("forests with different ci_group_size cannot be merged", "[regression,
     // Expected exception.
   }
 }
+
+TEST_CASE("forests are identical regardless of the number of threads", "[regression, forest]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  uint mtry = 3;
+  uint num_trees = 50;
+  uint seed = 42;
+  uint min_node_size = 1;
+  size_t ci_group_size = 2;
+  double sample_fraction = 0.35;
+  bool honesty = true;
+  double honesty_fraction = 0.5;
+  bool prune = true;
+  double alpha = 0.0;
+  double imbalance_penalty = 0.0;
+  std::vector<size_t> empty_clusters;
+  uint samples_per_cluster = 0;
+
+  ForestTrainer trainer = regression_trainer();
+  ForestPredictor predictor = regression_predictor(4);
+
+  ForestOptions single_threaded_options(num_trees, ci_group_size, sample_fraction, mtry, min_node_size, honesty,
+      honesty_fraction, prune, alpha, imbalance_penalty, 1, seed, empty_clusters, samples_per_cluster);
+  Forest single_threaded_forest = trainer.train(data, single_threaded_options);
+  std::vector<Prediction> expected = predictor.predict(single_threaded_forest, data, data, true);
+
+  ForestOptions multi_threaded_options(num_trees, ci_group_size, sample_fraction, mtry, min_node_size, honesty,
+      honesty_fraction, prune, alpha, imbalance_penalty, 3, seed, empty_clusters, samples_per_cluster);
+  Forest multi_threaded_forest = trainer.train(data, multi_threaded_options);
+  std::vector<Prediction> actual = predictor.predict(multi_threaded_forest, data, data, true);
+
+  REQUIRE(expected.size() == actual.size());
+  for (size_t sample = 0; sample < data.get_num_rows(); sample++) {
+    REQUIRE(expected[sample].get_predictions()[0] == actual[sample].get_predictions()[0]);
+    REQUIRE(expected[sample].get_variance_estimates()[0] == actual[sample].get_variance_estimates()[0]);
+  }
+}
@@ -15,11 +15,15 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
+#include <cmath>
+#include <stdexcept>
+
 #include "commons/utility.h"
 #include "forest/ForestPredictor.h"
 #include "forest/ForestPredictors.h"
 #include "forest/ForestTrainer.h"
 #include "forest/ForestTrainers.h"
+#include "forest/OOBConvergenceTracker.h"
 #include "utilities/ForestTestUtilities.h"
 
 #include "catch.hpp"
@@ -125,3 +129,153 @@ TEST_CASE("regression error estimates are shift invariant", "[regression, forest
 
   REQUIRE(equal_doubles(delta / predictions.size(), 0, 1e-1));
 }
+
+TEST_CASE("regression forests stop growing once OOB predictions converge", "[regression, forest]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  uint max_num_trees = 2000;
+  ForestOptions options(max_num_trees, 1, 0.5, 3, 5, true, 0.5, true, 0.0, 0.0, 4, 42, {}, 0);
+
+  size_t increment_size = 50;
+  double tolerance = 0.01;
+  OOBConvergence convergence;
+  Forest forest = trainer.train(data, options, increment_size, tolerance, convergence);
+
+  size_t num_trees = forest.get_trees().size();
+  REQUIRE(convergence.converged());
+  REQUIRE(num_trees < max_num_trees);
+  REQUIRE(convergence.get_prediction_changes().back() < tolerance);
+
+  const std::vector<size_t>& curve_num_trees = convergence.get_num_trees();
+  size_t num_increments = curve_num_trees.size();
+  REQUIRE(num_increments >= 2);
+  REQUIRE(curve_num_trees.back() == num_trees);
+  REQUIRE(convergence.get_oob_errors().size() == num_increments);
+  REQUIRE(convergence.get_excess_errors().size() == num_increments);
+  REQUIRE(convergence.get_prediction_changes().size() == num_increments);
+  for (size_t i = 0; i < num_increments; i++) {
+    REQUIRE(curve_num_trees[i] == (i + 1) * increment_size);
+  }
+
+  // The Monte Carlo error of the OOB predictions shrinks as trees are added.
+  REQUIRE(convergence.get_oob_errors().back() > 0);
+  REQUIRE(convergence.get_excess_errors().back() < convergence.get_excess_errors()[1]);
+}
+
+TEST_CASE("forests trained in increments match forests trained at once", "[regression, forest]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  ForestOptions options = ForestTestUtilities::default_options(true, 2);
+  Forest forest = trainer.train(data, options);
+
+  // A tolerance of zero is never reached, so all trees are grown.
+  OOBConvergence convergence;
+  Forest incremental_forest = trainer.train(data, options, 4, 0, convergence);
+  REQUIRE(!convergence.converged());
+  REQUIRE(incremental_forest.get_trees().size() == forest.get_trees().size());
+  REQUIRE(convergence.get_num_trees().back() == forest.get_trees().size());
+
+  ForestPredictor predictor = regression_predictor(4);
+  std::vector<Prediction> predictions = predictor.predict_oob(forest, data, false);
+  std::vector<Prediction> incremental_predictions = predictor.predict_oob(incremental_forest, data, false);
+  for (size_t i = 0; i < predictions.size(); i++) {
+    REQUIRE(predictions[i].get_predictions()[0] == incremental_predictions[i].get_predictions()[0]);
+  }
+}
+
+TEST_CASE("convergence error estimates are available beyond the number of error blocks", "[regression, forest]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  std::vector<size_t> empty_clusters;
+  ForestOptions options(100, 1, 0.5, 3, 5, true, 0.5, true, 0.0, 0.0, 4, 42, empty_clusters, 0);
+  ForestTrainer trainer = regression_trainer();
+
+  // Enough increments that some are folded into the same error block.
+  size_t increment_size = 4;
+  OOBConvergence convergence;
+  Forest forest = trainer.train(data, options, increment_size, 0, convergence);
+
+  size_t num_increments = convergence.get_num_trees().size();
+  REQUIRE(num_increments > OOBConvergenceTracker::NUM_ERROR_BLOCKS);
+  for (size_t i = 1; i < num_increments; i++) {
+    REQUIRE(!std::isnan(convergence.get_oob_errors()[i]));
+    REQUIRE(!std::isnan(convergence.get_excess_errors()[i]));
+  }
+}
+
+TEST_CASE("early stopping requires an optimized prediction strategy", "[quantile, forest]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = quantile_trainer({0.5});
+  ForestOptions options = ForestTestUtilities::default_options();
+
+  OOBConvergence convergence;
+  try {
+    trainer.train(data, options, 5, 0.01, convergence);
+    FAIL();
+  } catch (const std::runtime_error&) {
+    // Expected exception.
+  }
+}
+
+TEST_CASE("regression forests without leaf samples give identical predictions", "[regression, forest]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  std::vector<size_t> empty_clusters;
+  ForestOptions options(50, 2, 0.35, 3, 5, true, 0.5, true, 0.0, 0.0, 4, 42, empty_clusters, 0);
+  ForestOptions lean_options(50, 2, 0.35, 3, 5, true, 0.5, true, 0.0, 0.0, 4, 42, empty_clusters, 0, false);
+  ForestTrainer trainer = regression_trainer();
+  ForestPredictor predictor = regression_predictor(4);
+
+  Forest forest = trainer.train(data, options);
+  Forest lean_forest = trainer.train(data, lean_options);
+  for (const auto& tree : lean_forest.get_trees()) {
+    REQUIRE(!tree->has_leaf_samples());
+  }
+
+  std::vector<Prediction> expected = predictor.predict_oob(forest, data, true);
+  std::vector<Prediction> actual = predictor.predict_oob(lean_forest, data, true);
+  for (size_t sample = 0; sample < data.get_num_rows(); sample++) {
+    REQUIRE(equal_doubles(expected[sample].get_predictions()[0], actual[sample].get_predictions()[0], 1e-12));
+    REQUIRE(equal_doubles(expected[sample].get_variance_estimates()[0],
+                          actual[sample].get_variance_estimates()[0], 1e-12));
+  }
+
+  // Local linear prediction needs the forest weights, and so the leaf samples.
+  ForestPredictor ll_predictor = ll_regression_predictor(4, {0.1}, false, {0, 1});
+  try {
+    ll_predictor.predict_oob(lean_forest, data, false);
+    FAIL();
+  } catch (const std::runtime_error&) {
+    // Expected exception.
+  }
+}
+
+TEST_CASE("leaf samples can only be discarded with an optimized prediction strategy", "[quantile, forest]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  std::vector<size_t> empty_clusters;
+  ForestOptions lean_options(50, 1, 0.35, 3, 5, true, 0.5, true, 0.0, 0.0, 4, 42, empty_clusters, 0, false);
+  ForestTrainer trainer = quantile_trainer({0.5});
+
+  try {
+    trainer.train(data, lean_options);
+    FAIL();
+  } catch (const std::runtime_error&) {
+    // Expected exception.
+  }
+}
@@ -0,0 +1,81 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <stdexcept>
+
+#include "forest/ForestPredictor.h"
+#include "forest/ForestPredictors.h"
+#include "forest/ForestTrainer.h"
+#include "forest/ForestTrainers.h"
+#include "utilities/ForestTestUtilities.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+TEST_CASE_METHOD(GaussianDataFixture, "forest training stops once the memory budget is exhausted", "[regression, forest]") {
+  uint num_trees = 100;
+  size_t ci_group_size = 2;
+  std::vector<size_t> empty_clusters;
+  ForestOptions options(num_trees, ci_group_size, 0.35, 3, 1, true, 0.5, true, 0.0, 0.0, 4, 42,
+      empty_clusters, 0);
+  ForestTrainer trainer = regression_trainer();
+
+  Forest full_forest = trainer.train(data, options);
+  size_t tree_memory = full_forest.get_trees()[0]->estimate_memory_usage();
+
+  size_t max_memory = 10 * tree_memory;
+  TrainingBudget budget(0, max_memory);
+  Forest forest = trainer.train(data, options, budget);
+
+  size_t num_trained = forest.get_trees().size();
+  REQUIRE(num_trained > 0);
+  REQUIRE(num_trained < num_trees);
+  REQUIRE(num_trained % ci_group_size == 0);
+  REQUIRE(budget.get_memory_used() <= max_memory);
+}
+
+TEST_CASE_METHOD(GaussianDataFixture, "forest training fails if no tree group fits in the time budget", "[regression, forest]") {
+  ForestOptions options = ForestTestUtilities::default_options(true, 2);
+  ForestTrainer trainer = regression_trainer();
+
+  TrainingBudget budget(1e-9, 0);
+  try {
+    trainer.train(data, options, budget);
+    FAIL();
+  } catch (const std::runtime_error& e) {
+    // Expected exception.
+  }
+}
+
+TEST_CASE_METHOD(GaussianDataFixture, "forests trained with an unlimited budget match regular forests", "[regression, forest]") {
+  ForestOptions options = ForestTestUtilities::default_options(true, 2);
+  ForestTrainer trainer = regression_trainer();
+  ForestPredictor predictor = regression_predictor(4);
+
+  Forest expected_forest = trainer.train(data, options);
+  std::vector<Prediction> expected = predictor.predict_oob(expected_forest, data, false);
+
+  TrainingBudget budget;
+  Forest forest = trainer.train(data, options, budget);
+  std::vector<Prediction> actual = predictor.predict_oob(forest, data, false);
+
+  REQUIRE(forest.get_trees().size() == expected_forest.get_trees().size());
+  for (size_t sample = 0; sample < data.get_num_rows(); sample++) {
+    REQUIRE(expected[sample].get_predictions()[0] == actual[sample].get_predictions()[0]);
+  }
+}
@@ -0,0 +1,75 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <stdexcept>
+
+#include "analysis/ForestWeightsComputer.h"
+#include "forest/ForestPredictor.h"
+#include "forest/ForestPredictors.h"
+#include "forest/ForestTrainers.h"
+#include "prediction/QuantilePredictionStrategy.h"
+#include "prediction/collector/DefaultPredictionCollector.h"
+#include "prediction/collector/TreeTraverser.h"
+#include "utilities/ForestTestUtilities.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+TEST_CASE_METHOD(GaussianDataFixture, "predictions from a forest kernel match predictions from traversal", "[quantile, prediction]") {
+  ForestTrainer trainer = quantile_trainer({0.5});
+  Forest forest = trainer.train(data, ForestTestUtilities::default_honest_options());
+
+  ForestWeightsComputer weights_computer(4);
+  ForestWeights kernel = weights_computer.compute(forest, data, data, true);
+
+  // The kernel holds the weights that QuantilePredictionStrategy sees, so it is compared against
+  // traversal with that strategy rather than the merging quantile collector.
+  TreeTraverser traverser(4);
+  LeafAssignments leaf_assignments = traverser.get_leaf_assignments(forest, data, true);
+
+  std::vector<std::vector<double>> quantile_sets = {{0.5}, {0.1, 0.9}, {0.25, 0.5, 0.75}};
+  for (const std::vector<double>& quantiles : quantile_sets) {
+    std::unique_ptr<DefaultPredictionStrategy> strategy(new QuantilePredictionStrategy(quantiles));
+    DefaultPredictionCollector collector(std::move(strategy), 4);
+    std::vector<Prediction> expected = collector.collect_predictions(forest, data, data,
+        leaf_assignments, false, false);
+
+    ForestPredictor predictor = quantile_predictor(4, quantiles);
+    std::vector<Prediction> actual = predictor.predict_with_kernel(kernel, data, data);
+
+    REQUIRE(expected.size() == actual.size());
+    for (size_t sample = 0; sample < data.get_num_rows(); sample++) {
+      REQUIRE(expected[sample].get_predictions() == actual[sample].get_predictions());
+      REQUIRE(!actual[sample].contains_variance_estimates());
+    }
+  }
+}
+
+TEST_CASE_METHOD(GaussianDataFixture, "predicting from a forest kernel requires a default strategy", "[regression, prediction]") {
+  ForestTrainer trainer = regression_trainer();
+  Forest forest = trainer.train(data, ForestTestUtilities::default_honest_options());
+  ForestWeights kernel = ForestWeightsComputer(4).compute(forest, data, data, true);
+
+  ForestPredictor predictor = regression_predictor(4);
+  try {
+    predictor.predict_with_kernel(kernel, data, data);
+    FAIL();
+  } catch (const std::runtime_error&) {
+    // Expected exception.
+  }
+}
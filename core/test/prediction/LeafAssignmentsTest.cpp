@@ -0,0 +1,74 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <stdexcept>
+
+#include "commons/utility.h"
+#include "forest/ForestPredictor.h"
+#include "forest/ForestPredictors.h"
+#include "forest/ForestTrainers.h"
+#include "prediction/collector/TreeTraverser.h"
+#include "utilities/ForestTestUtilities.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+TEST_CASE_METHOD(GaussianDataFixture, "leaf assignments can be reused across predictions", "[regression, prediction]") {
+  ForestOptions options = ForestTestUtilities::default_options(true, 2, 5);
+  ForestTrainer trainer = regression_trainer();
+  Forest forest = trainer.train(data, options);
+
+  TreeTraverser traverser(4);
+  for (bool oob_prediction : {false, true}) {
+    LeafAssignments leaf_assignments = traverser.get_leaf_assignments(forest, data, oob_prediction);
+    REQUIRE(leaf_assignments.is_oob_prediction() == oob_prediction);
+
+    std::vector<ForestPredictor> predictors;
+    predictors.push_back(regression_predictor(4));
+    predictors.push_back(ll_regression_predictor(4, {0.1}, false, {0}));
+    predictors.push_back(ll_regression_predictor(4, {0.1}, false, {1, 2}));
+
+    for (const ForestPredictor& predictor : predictors) {
+      std::vector<Prediction> expected = oob_prediction
+          ? predictor.predict_oob(forest, data, false)
+          : predictor.predict(forest, data, data, false);
+      std::vector<Prediction> actual = predictor.predict(forest, data, data, leaf_assignments, false);
+
+      REQUIRE(expected.size() == actual.size());
+      for (size_t sample = 0; sample < data.get_num_rows(); sample++) {
+        REQUIRE(equal_doubles(expected[sample].get_predictions()[0], actual[sample].get_predictions()[0], 1e-10));
+      }
+    }
+  }
+}
+
+TEST_CASE_METHOD(GaussianDataFixture, "leaf assignments cannot be reused with a different forest", "[regression, prediction]") {
+  ForestTrainer trainer = regression_trainer();
+  Forest forest = trainer.train(data, ForestTestUtilities::default_options(true, 2, 5));
+  LeafAssignments leaf_assignments = TreeTraverser(4).get_leaf_assignments(forest, data, false);
+
+  Forest small_forest = trainer.train(data, ForestOptions(10, 2, 0.35, 3, 5, true, 0.5, true, 0.0, 0.0, 4, 42,
+                                                          std::vector<size_t>(), 0));
+  ForestPredictor predictor = regression_predictor(4);
+  try {
+    predictor.predict(small_forest, data, data, leaf_assignments, false);
+    FAIL();
+  } catch (const std::runtime_error&) {
+    // Expected exception.
+  }
+}
@@ -0,0 +1,65 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+
+#include "commons/utility.h"
+#include "forest/ForestTrainers.h"
+#include "prediction/collector/LeafMomentComputer.h"
+#include "prediction/collector/TreeTraverser.h"
+#include "utilities/ForestTestUtilities.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+TEST_CASE("leaf moments do not depend on how test samples are split into blocks", "[local linear, prediction]") {
+  auto data_vec = load_data("test/forest/resources/friedman.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  data.set_treatment_index(9);
+
+  ForestTrainer trainer = regression_trainer();
+  Forest forest = trainer.train(data, ForestTestUtilities::default_options());
+  TreeTraverser traverser(2);
+  LeafAssignments leaf_assignments = traverser.get_leaf_assignments(forest, data, true);
+
+  for (bool interact_treatment : {false, true}) {
+    LeafMomentComputer moment_computer({0, 1, 3}, data, interact_treatment);
+    size_t num_moments = moment_computer.get_num_moments();
+    REQUIRE(moment_computer.get_block_size() * num_moments <= LeafMomentComputer::MAX_BLOCK_MOMENTS);
+
+    size_t num_samples = data.get_num_rows();
+    std::vector<double> moments;
+    std::vector<size_t> num_leaves;
+    moment_computer.compute(0, num_samples, forest, data, leaf_assignments, moments, num_leaves);
+
+    std::vector<double> block_moments;
+    std::vector<size_t> block_num_leaves;
+    size_t block_size = 7;
+    for (size_t start = 0; start < num_samples; start += block_size) {
+      size_t size = std::min(block_size, num_samples - start);
+      moment_computer.compute(start, size, forest, data, leaf_assignments, block_moments, block_num_leaves);
+      for (size_t i = 0; i < size; ++i) {
+        REQUIRE(block_num_leaves[i] == num_leaves[start + i]);
+        for (size_t k = 0; k < num_moments; ++k) {
+          REQUIRE(block_moments[i * num_moments + k] == moments[(start + i) * num_moments + k]);
+        }
+      }
+    }
+  }
+}
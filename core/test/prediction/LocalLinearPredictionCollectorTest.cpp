@@ -0,0 +1,94 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+
+#include "commons/utility.h"
+#include "forest/ForestTrainers.h"
+#include "prediction/LocalLinearPredictionStrategy.h"
+#include "prediction/collector/DefaultPredictionCollector.h"
+#include "prediction/collector/LocalLinearPredictionCollector.h"
+#include "prediction/collector/TreeTraverser.h"
+#include "utilities/ForestTestUtilities.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+TEST_CASE("local linear predictions from leaf moments match predictions from sample weights", "[local linear, prediction]") {
+  auto data_vec = load_data("test/forest/resources/friedman.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  std::vector<size_t> linear_correction_variables = {0, 1, 3, 4};
+  std::vector<double> lambdas = {0.01, 0.1, 1.0};
+
+  ForestTrainer trainer = regression_trainer();
+  Forest forest = trainer.train(data, ForestTestUtilities::default_options());
+
+  uint num_threads = 3;
+  TreeTraverser traverser(num_threads);
+  for (bool weight_penalty : {false, true}) {
+    LocalLinearPredictionCollector collector(lambdas, weight_penalty, linear_correction_variables, num_threads);
+    std::unique_ptr<DefaultPredictionStrategy> strategy(
+        new LocalLinearPredictionStrategy(lambdas, weight_penalty, linear_correction_variables));
+    DefaultPredictionCollector default_collector(std::move(strategy), num_threads);
+
+    for (bool oob_prediction : {false, true}) {
+      LeafAssignments leaf_assignments = traverser.get_leaf_assignments(forest, data, oob_prediction);
+      std::vector<Prediction> expected = default_collector.collect_predictions(forest, data, data,
+          leaf_assignments, false, false);
+      std::vector<Prediction> actual = collector.collect_predictions(forest, data, data,
+          leaf_assignments, false, false);
+
+      REQUIRE(expected.size() == actual.size());
+      for (size_t sample = 0; sample < data.get_num_rows(); sample++) {
+        const std::vector<double>& expected_path = expected[sample].get_predictions();
+        const std::vector<double>& actual_path = actual[sample].get_predictions();
+        REQUIRE(expected_path.size() == actual_path.size());
+        for (size_t i = 0; i < lambdas.size(); i++) {
+          double tolerance = 1e-8 * std::max(1.0, std::abs(expected_path[i]));
+          REQUIRE(equal_doubles(expected_path[i], actual_path[i], tolerance));
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("local linear predictions from leaf moments fall back to sample weights for variance", "[local linear, prediction]") {
+  auto data_vec = load_data("test/forest/resources/friedman.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  std::vector<size_t> linear_correction_variables = {0, 1};
+  std::vector<double> lambdas = {0.1};
+
+  ForestOptions options = ForestTestUtilities::default_options(false, 2);
+  ForestTrainer trainer = regression_trainer();
+  Forest forest = trainer.train(data, options);
+
+  uint num_threads = 2;
+  TreeTraverser traverser(num_threads);
+  LeafAssignments leaf_assignments = traverser.get_leaf_assignments(forest, data, true);
+  LocalLinearPredictionCollector collector(lambdas, false, linear_correction_variables, num_threads);
+  std::vector<Prediction> predictions = collector.collect_predictions(forest, data, data,
+      leaf_assignments, true, false);
+
+  REQUIRE(predictions.size() == data.get_num_rows());
+  for (const Prediction& prediction : predictions) {
+    REQUIRE(prediction.contains_variance_estimates());
+  }
+}
@@ -0,0 +1,55 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include "commons/utility.h"
+#include "forest/ForestTrainers.h"
+#include "prediction/RegressionPredictionStrategy.h"
+#include "prediction/collector/OptimizedPredictionCollector.h"
+#include "prediction/collector/TreeTraverser.h"
+#include "utilities/ForestTestUtilities.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+TEST_CASE_METHOD(GaussianDataFixture, "fused optimized predictions match predictions from materialized leaf nodes", "[regression, prediction]") {
+  ForestOptions options = ForestTestUtilities::default_options(true, 2, 5);
+  ForestTrainer trainer = regression_trainer();
+  Forest forest = trainer.train(data, options);
+
+  uint num_threads = 3;
+  std::unique_ptr<OptimizedPredictionStrategy> strategy(new RegressionPredictionStrategy());
+  OptimizedPredictionCollector collector(std::move(strategy), num_threads);
+  TreeTraverser traverser(num_threads);
+
+  for (bool oob_prediction : {false, true}) {
+    LeafAssignments leaf_assignments = traverser.get_leaf_assignments(forest, data, oob_prediction);
+    std::vector<Prediction> expected = collector.collect_predictions(forest, data, data,
+        leaf_assignments, true, oob_prediction);
+    std::vector<Prediction> actual = collector.collect_predictions(forest, data, true, oob_prediction);
+
+    REQUIRE(expected.size() == actual.size());
+    for (size_t sample = 0; sample < data.get_num_rows(); sample++) {
+      REQUIRE(equal_doubles(expected[sample].get_predictions()[0], actual[sample].get_predictions()[0], 1e-12));
+      REQUIRE(equal_doubles(expected[sample].get_variance_estimates()[0],
+                            actual[sample].get_variance_estimates()[0], 1e-12));
+      if (oob_prediction) {
+        REQUIRE(equal_doubles(expected[sample].get_error_estimates()[0], actual[sample].get_error_estimates()[0], 1e-12));
+      }
+    }
+  }
+}
@@ -0,0 +1,50 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <stdexcept>
+
+#include "prediction/PredictionValues.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+TEST_CASE("prediction values round trip through flat storage", "[prediction, unit]") {
+  std::vector<std::vector<double>> values = {{}, {1.0, 2.0}, {}, {3.0, 4.0}};
+  PredictionValues prediction_values(values, 2);
+
+  REQUIRE(prediction_values.get_num_nodes() == 4);
+  REQUIRE(prediction_values.empty(0));
+  REQUIRE(!prediction_values.empty(1));
+  REQUIRE(prediction_values.get(3, 1) == 4.0);
+  REQUIRE(prediction_values.get_values(2).empty());
+  REQUIRE(prediction_values.get_all_values() == values);
+
+  // Copies must point at their own storage.
+  PredictionValues copy(prediction_values);
+  prediction_values = PredictionValues();
+  REQUIRE(copy.get_all_values() == values);
+}
+
+TEST_CASE("prediction values must have num_types values per non-empty node", "[prediction, unit]") {
+  try {
+    PredictionValues({{1.0, 2.0}, {}, {3.0}}, 2);
+    FAIL();
+  } catch (const std::runtime_error&) {
+    // Expected exception.
+  }
+}
@@ -0,0 +1,52 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include "prediction/PredictionValues.h"
+#include "prediction/PredictionValuesView.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+TEST_CASE("prediction value views reference rows owned elsewhere", "[prediction, unit]") {
+  PredictionValues first({{1.0, 2.0}, {}}, 2);
+  PredictionValues second({{}, {5.0, 6.0}}, 2);
+
+  PredictionValuesView view(3, 2);
+  view.set_row(0, first.get_row(0));
+  view.set_row(2, second.get_row(1));
+
+  REQUIRE(view.get_num_nodes() == 3);
+  REQUIRE(view.empty(1));
+  REQUIRE(view.get(0, 1) == 2.0);
+  REQUIRE(view.get(2, 0) == 5.0);
+
+  PredictionValuesView view_copy(view);
+  REQUIRE(view_copy.get_row(2) == second.get_row(1));
+}
+
+TEST_CASE("prediction value views can cover all nodes of prediction values", "[prediction, unit]") {
+  PredictionValues prediction_values({{}, {1.0, 2.0}, {3.0, 4.0}}, 2);
+  PredictionValuesView view(prediction_values);
+
+  REQUIRE(view.get_num_nodes() == 3);
+  REQUIRE(view.get_num_types() == 2);
+  REQUIRE(view.empty(0));
+  for (size_t node = 1; node < 3; ++node) {
+    REQUIRE(view.get_row(node) == prediction_values.get_row(node));
+  }
+}
@@ -0,0 +1,139 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cmath>
+
+#include "commons/utility.h"
+#include "forest/ForestTrainers.h"
+#include "prediction/QuantilePredictionStrategy.h"
+#include "prediction/collector/DefaultPredictionCollector.h"
+#include "prediction/collector/QuantilePredictionCollector.h"
+#include "prediction/collector/TreeTraverser.h"
+#include "utilities/ForestTestUtilities.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+TEST_CASE("merged quantile predictions match predictions from sorted sample weights", "[quantile, prediction]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  std::vector<double> quantiles = {0.1, 0.25, 0.5, 0.75, 0.9};
+  ForestTrainer trainer = quantile_trainer(quantiles);
+  Forest forest = trainer.train(data, ForestTestUtilities::default_honest_options());
+
+  uint num_threads = 3;
+  QuantilePredictionCollector collector(quantiles, num_threads);
+  TreeTraverser traverser(num_threads);
+
+  std::unique_ptr<DefaultPredictionStrategy> strategy(new QuantilePredictionStrategy(quantiles));
+  DefaultPredictionCollector default_collector(std::move(strategy), num_threads);
+
+  // The collector sums the sample weights in a different order than the strategy, so a
+  // cumulative weight that lands exactly on a quantile may round to either side of it. Such
+  // ties may instead match the strategy's prediction for a quantile nudged up or down.
+  double epsilon = 1e-10;
+  std::vector<double> lower_quantiles;
+  std::vector<double> upper_quantiles;
+  for (double quantile : quantiles) {
+    lower_quantiles.push_back(quantile - epsilon);
+    upper_quantiles.push_back(quantile + epsilon);
+  }
+  std::unique_ptr<DefaultPredictionStrategy> lower_strategy(new QuantilePredictionStrategy(lower_quantiles));
+  DefaultPredictionCollector lower_collector(std::move(lower_strategy), num_threads);
+  std::unique_ptr<DefaultPredictionStrategy> upper_strategy(new QuantilePredictionStrategy(upper_quantiles));
+  DefaultPredictionCollector upper_collector(std::move(upper_strategy), num_threads);
+
+  for (bool oob_prediction : {false, true}) {
+    LeafAssignments leaf_assignments = traverser.get_leaf_assignments(forest, data, oob_prediction);
+    std::vector<Prediction> expected = default_collector.collect_predictions(forest, data, data,
+        leaf_assignments, false, false);
+    std::vector<Prediction> lower = lower_collector.collect_predictions(forest, data, data,
+        leaf_assignments, false, false);
+    std::vector<Prediction> upper = upper_collector.collect_predictions(forest, data, data,
+        leaf_assignments, false, false);
+    std::vector<Prediction> actual = collector.collect_predictions(forest, data, data,
+        leaf_assignments, false, false);
+
+    REQUIRE(expected.size() == actual.size());
+    size_t num_ties = 0;
+    for (size_t sample = 0; sample < data.get_num_rows(); sample++) {
+      const std::vector<double>& expected_quantiles = expected[sample].get_predictions();
+      const std::vector<double>& actual_quantiles = actual[sample].get_predictions();
+      REQUIRE(expected_quantiles.size() == actual_quantiles.size());
+      for (size_t i = 0; i < quantiles.size(); i++) {
+        if (std::isnan(expected_quantiles[i])) {
+          REQUIRE(std::isnan(actual_quantiles[i]));
+        } else if (actual_quantiles[i] != expected_quantiles[i]) {
+          REQUIRE((actual_quantiles[i] == lower[sample].get_predictions()[i]
+                   || actual_quantiles[i] == upper[sample].get_predictions()[i]));
+          num_ties++;
+        }
+      }
+    }
+    REQUIRE(num_ties < data.get_num_rows() / 10);
+  }
+
+  LeafAssignments leaf_assignments = traverser.get_leaf_assignments(forest, data, false);
+  try {
+    collector.collect_predictions(forest, data, data, leaf_assignments, true, false);
+    FAIL();
+  } catch (const std::runtime_error&) {
+    // Expected exception.
+  }
+}
+
+TEST_CASE("merged quantile predictions are unchanged when the sorted leaf ranks are reused", "[quantile, prediction]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  std::vector<double> quantiles = {0.1, 0.5, 0.9};
+  ForestTrainer trainer = quantile_trainer(quantiles);
+  Forest forest = trainer.train(data, ForestTestUtilities::default_honest_options());
+
+  uint num_threads = 3;
+  TreeTraverser traverser(num_threads);
+  LeafAssignments leaf_assignments = traverser.get_leaf_assignments(forest, data, false);
+
+  QuantilePredictionCollector collector(quantiles, num_threads);
+  std::vector<Prediction> first = collector.collect_predictions(forest, data, data,
+      leaf_assignments, false, false);
+  std::vector<Prediction> second = collector.collect_predictions(forest, data, data,
+      leaf_assignments, false, false);
+
+  QuantilePredictionCollector fresh_collector(quantiles, num_threads);
+  std::vector<Prediction> expected = fresh_collector.collect_predictions(forest, data, data,
+      leaf_assignments, false, false);
+
+  REQUIRE(first.size() == expected.size());
+  REQUIRE(second.size() == expected.size());
+  for (size_t sample = 0; sample < data.get_num_rows(); sample++) {
+    for (size_t i = 0; i < quantiles.size(); i++) {
+      double value = expected[sample].get_predictions()[i];
+      if (std::isnan(value)) {
+        REQUIRE(std::isnan(first[sample].get_predictions()[i]));
+        REQUIRE(std::isnan(second[sample].get_predictions()[i]));
+      } else {
+        REQUIRE(first[sample].get_predictions()[i] == value);
+        REQUIRE(second[sample].get_predictions()[i] == value);
+      }
+    }
+  }
+}
@@ -0,0 +1,116 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cmath>
+
+#include "commons/utility.h"
+#include "forest/ForestTrainers.h"
+#include "prediction/collector/QuickScorer.h"
+#include "prediction/collector/TreeTraverser.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+namespace {
+
+std::pair<std::vector<double>, std::vector<size_t>> load_data_with_missing_values() {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  size_t num_rows = data_vec.second[0];
+  for (size_t r = 0; r < num_rows; r++) {
+    if (r % 5 == 0) {
+      set_data(data_vec, r, 0, NAN);
+    }
+    if (r % 7 == 0) {
+      set_data(data_vec, r, 1, NAN);
+    }
+  }
+  return data_vec;
+}
+
+std::vector<std::vector<size_t>> find_leaf_nodes(const Forest& forest, const Data& data) {
+  std::vector<std::vector<size_t>> leaf_nodes;
+  for (const std::unique_ptr<Tree>& tree : forest.get_trees()) {
+    std::vector<size_t> tree_leaf_nodes;
+    for (size_t sample = 0; sample < data.get_num_rows(); sample++) {
+      tree_leaf_nodes.push_back(tree->find_leaf_node(data, sample));
+    }
+    leaf_nodes.push_back(tree_leaf_nodes);
+  }
+  return leaf_nodes;
+}
+
+} // namespace
+
+TEST_CASE("quick scorer finds the same leaf nodes as tree traversal", "[prediction, unit]") {
+  auto data_vec = load_data_with_missing_values();
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  std::vector<size_t> empty_clusters;
+  ForestTrainer trainer = regression_trainer();
+
+  for (uint min_node_size : {50, 5}) {
+    ForestOptions options(20, 1, 0.5, 5, min_node_size, false, 0.5, true, 0.0, 0.0, 2, 42, empty_clusters, 0);
+    Forest forest = trainer.train(data, options);
+
+    QuickScorer scorer(forest, 3);
+    if (min_node_size == 50) {
+      REQUIRE(scorer.get_num_compiled_trees() == forest.get_trees().size());
+      REQUIRE(QuickScorer::can_compile_all_trees(forest));
+    } else {
+      REQUIRE(scorer.get_num_compiled_trees() < forest.get_trees().size());
+      REQUIRE(!QuickScorer::can_compile_all_trees(forest));
+    }
+
+    std::vector<std::vector<size_t>> expected = find_leaf_nodes(forest, data);
+    std::vector<std::vector<size_t>> actual = scorer.get_leaf_nodes<size_t>(data);
+    REQUIRE(expected == actual);
+  }
+}
+
+TEST_CASE("tree traversal of shallow forests matches per-tree traversal", "[prediction, unit]") {
+  auto data_vec = load_data_with_missing_values();
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  std::vector<size_t> empty_clusters;
+  ForestTrainer trainer = regression_trainer();
+  ForestOptions options(20, 1, 0.5, 5, 50, false, 0.5, true, 0.0, 0.0, 2, 42, empty_clusters, 0);
+  Forest forest = trainer.train(data, options);
+  REQUIRE(QuickScorer::can_compile_all_trees(forest));
+
+  TreeTraverser traverser(2);
+  std::vector<std::vector<size_t>> expected = find_leaf_nodes(forest, data);
+
+  for (bool oob_prediction : {false, true}) {
+    std::vector<std::vector<size_t>> leaf_nodes = traverser.get_leaf_nodes(forest, data, oob_prediction);
+    LeafAssignments leaf_assignments = traverser.get_leaf_assignments(forest, data, oob_prediction);
+    ValidTreesBySample valid_trees_by_sample = traverser.get_valid_trees_by_sample(forest, data, oob_prediction);
+
+    for (size_t tree = 0; tree < forest.get_trees().size(); tree++) {
+      for (size_t sample = 0; sample < data.get_num_rows(); sample++) {
+        if (valid_trees_by_sample.is_valid(sample, tree)) {
+          REQUIRE(leaf_nodes[tree][sample] == expected[tree][sample]);
+          REQUIRE(leaf_assignments.get_leaf_node(tree, sample) == expected[tree][sample]);
+        } else {
+          REQUIRE(leaf_nodes[tree][sample] == 0);
+        }
+      }
+    }
+  }
+}
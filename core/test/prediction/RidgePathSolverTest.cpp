@@ -0,0 +1,133 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <random>
+#include <vector>
+
+#include "Eigen/Dense"
+#include "commons/utility.h"
+#include "prediction/RidgePathSolver.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+Eigen::VectorXd solve_directly(const Eigen::MatrixXd& M,
+                               const Eigen::VectorXd& r,
+                               const Eigen::VectorXd& penalty,
+                               double lambda) {
+  Eigen::MatrixXd penalized = M;
+  penalized.diagonal() += lambda * penalty;
+  return penalized.ldlt().solve(r);
+}
+
+TEST_CASE("ridge path solutions match a direct solve for each lambda", "[prediction, ridge]") {
+  std::mt19937_64 random_number_generator(42);
+  std::normal_distribution<double> normal(0.0, 1.0);
+
+  size_t num_samples = 50;
+  size_t dimension = 6;
+  Eigen::MatrixXd X(num_samples, dimension);
+  Eigen::VectorXd Y(num_samples);
+  for (size_t i = 0; i < num_samples; ++i) {
+    X(i, 0) = 1.0;
+    for (size_t j = 1; j < dimension; ++j) {
+      X(i, j) = normal(random_number_generator);
+    }
+    Y(i) = normal(random_number_generator);
+  }
+  Eigen::MatrixXd M = X.transpose() * X / num_samples;
+  Eigen::VectorXd r = X.transpose() * Y / num_samples;
+
+  // Penalize all but the intercept, and then all but the intercept and one other coefficient.
+  Eigen::VectorXd all_but_intercept = M.diagonal();
+  all_but_intercept(0) = 0.0;
+  Eigen::VectorXd two_unpenalized = Eigen::VectorXd::Constant(dimension, 0.5);
+  two_unpenalized(0) = 0.0;
+  two_unpenalized(3) = 0.0;
+
+  std::vector<std::vector<size_t>> unpenalized = {{0}, {0, 3}};
+  std::vector<Eigen::VectorXd> penalties = {all_but_intercept, two_unpenalized};
+  for (size_t i = 0; i < penalties.size(); ++i) {
+    const Eigen::VectorXd& penalty = penalties[i];
+    RidgePathSolver solver(M, r, penalty, unpenalized[i]);
+    for (double lambda : {0.0, 0.01, 0.1, 1.0, 10.0}) {
+      Eigen::VectorXd expected = solve_directly(M, r, penalty, lambda);
+      Eigen::VectorXd actual = solver.solve(lambda);
+      REQUIRE(actual.size() == expected.size());
+      for (size_t j = 0; j < dimension; ++j) {
+        REQUIRE(equal_doubles(expected(j), actual(j), 1e-10));
+      }
+    }
+  }
+}
+
+TEST_CASE("ridge path solver handles a fully unpenalized problem", "[prediction, ridge]") {
+  Eigen::MatrixXd M(2, 2);
+  M << 2.0, 0.5,
+       0.5, 1.0;
+  Eigen::VectorXd r(2);
+  r << 1.0, -1.0;
+
+  RidgePathSolver solver(M, r, Eigen::VectorXd::Zero(2), {0, 1});
+  Eigen::VectorXd expected = M.ldlt().solve(r);
+  for (double lambda : {0.0, 1.0}) {
+    Eigen::VectorXd actual = solver.solve(lambda);
+    REQUIRE(equal_doubles(expected(0), actual(0), 1e-12));
+    REQUIRE(equal_doubles(expected(1), actual(1), 1e-12));
+  }
+}
+
+TEST_CASE("ridge path solutions match a direct solve for degenerate designs", "[prediction, ridge]") {
+  std::mt19937_64 random_number_generator(42);
+  std::normal_distribution<double> normal(0.0, 1.0);
+
+  // Column 2 is constant at the test sample's value, so it is zero once centered,
+  // and column 3 duplicates column 1, so M is singular.
+  size_t num_samples = 50;
+  size_t dimension = 5;
+  Eigen::MatrixXd X(num_samples, dimension);
+  Eigen::VectorXd Y(num_samples);
+  for (size_t i = 0; i < num_samples; ++i) {
+    X(i, 0) = 1.0;
+    X(i, 1) = normal(random_number_generator);
+    X(i, 2) = 0.0;
+    X(i, 3) = X(i, 1);
+    X(i, 4) = normal(random_number_generator);
+    Y(i) = normal(random_number_generator);
+  }
+  Eigen::MatrixXd M = X.transpose() * X / num_samples;
+  Eigen::VectorXd r = X.transpose() * Y / num_samples;
+
+  // A covariance penalty, which is zero for the constant column, and a standard penalty.
+  Eigen::VectorXd covariance_penalty = M.diagonal();
+  covariance_penalty(0) = 0.0;
+  Eigen::VectorXd standard_penalty = Eigen::VectorXd::Constant(dimension, M.trace() / dimension);
+  standard_penalty(0) = 0.0;
+
+  for (const Eigen::VectorXd& penalty : {covariance_penalty, standard_penalty}) {
+    RidgePathSolver solver(M, r, penalty, {0});
+    for (double lambda : {0.0, 0.01, 0.1, 1.0}) {
+      Eigen::VectorXd expected = solve_directly(M, r, penalty, lambda);
+      Eigen::VectorXd actual = solver.solve(lambda);
+      REQUIRE(actual.size() == expected.size());
+      for (size_t j = 0; j < dimension; ++j) {
+        REQUIRE(equal_doubles(expected(j), actual(j), 1e-10));
+      }
+    }
+  }
+}
@@ -0,0 +1,79 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include "commons/utility.h"
+#include "forest/ForestTrainers.h"
+#include "prediction/collector/SampleWeightComputer.h"
+#include "prediction/collector/TreeTraverser.h"
+#include "utilities/ForestTestUtilities.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+TEST_CASE("sample weights are sorted, normalized and independent across test samples", "[prediction, unit]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = quantile_trainer({0.5});
+  Forest forest = trainer.train(data, ForestTestUtilities::default_honest_options());
+
+  TreeTraverser traverser(2);
+  LeafAssignments leaf_assignments = traverser.get_leaf_assignments(forest, data, true);
+
+  SampleWeightComputer shared_computer(data.get_num_rows());
+  std::vector<std::pair<size_t, double>> weights;
+  std::vector<std::pair<size_t, double>> fresh_weights;
+  for (size_t sample = 0; sample < 20; ++sample) {
+    shared_computer.compute_weights(sample, forest, leaf_assignments, weights);
+    SampleWeightComputer fresh_computer(data.get_num_rows());
+    fresh_computer.compute_weights(sample, forest, leaf_assignments, fresh_weights);
+    REQUIRE(weights == fresh_weights);
+
+    double total_weight = 0.0;
+    for (size_t i = 0; i < weights.size(); ++i) {
+      REQUIRE(weights[i].second > 0.0);
+      if (i > 0) {
+        REQUIRE(weights[i - 1].first < weights[i].first);
+      }
+      total_weight += weights[i].second;
+    }
+    REQUIRE(equal_doubles(total_weight, 1.0, 1e-10));
+  }
+}
+
+TEST_CASE("sample weight counts match the number of computed weights", "[prediction, unit]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = quantile_trainer({0.5});
+  Forest forest = trainer.train(data, ForestTestUtilities::default_honest_options());
+
+  TreeTraverser traverser(2);
+  ValidTreesBySample valid_trees_by_sample = traverser.get_valid_trees_by_sample(forest, data, true);
+
+  // Counting and computing share the dense buffer, so interleave them to check it is reset.
+  SampleWeightComputer computer(data.get_num_rows());
+  std::vector<std::pair<size_t, double>> weights;
+  for (size_t sample = 0; sample < 20; ++sample) {
+    size_t num_weights = computer.count_weights(sample, forest, data, valid_trees_by_sample);
+    computer.compute_weights(sample, forest, data, valid_trees_by_sample, weights);
+    REQUIRE(num_weights == weights.size());
+  }
+}
@@ -0,0 +1,71 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cmath>
+
+#include "commons/utility.h"
+#include "forest/ForestTrainers.h"
+#include "prediction/SurvivalPredictionStrategy.h"
+#include "prediction/collector/DefaultPredictionCollector.h"
+#include "prediction/collector/SurvivalPredictionCollector.h"
+#include "prediction/collector/TreeTraverser.h"
+#include "utilities/ForestTestUtilities.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+TEST_CASE("survival predictions from leaf count tables match predictions from sample weights", "[survival, prediction]") {
+  size_t num_failures = 149;
+  auto data_vec = load_data("test/forest/resources/survival_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(5);
+  data.set_censor_index(6);
+
+  ForestTrainer trainer = survival_trainer();
+  Forest forest = trainer.train(data, ForestTestUtilities::default_options());
+
+  uint num_threads = 3;
+  TreeTraverser traverser(num_threads);
+  for (int prediction_type : {SurvivalPredictionStrategy::KAPLAN_MEIER, SurvivalPredictionStrategy::NELSON_AALEN}) {
+    SurvivalPredictionCollector collector(num_failures, prediction_type, num_threads);
+    std::unique_ptr<DefaultPredictionStrategy> strategy(new SurvivalPredictionStrategy(num_failures, prediction_type));
+    DefaultPredictionCollector default_collector(std::move(strategy), num_threads);
+
+    for (bool oob_prediction : {false, true}) {
+      LeafAssignments leaf_assignments = traverser.get_leaf_assignments(forest, data, oob_prediction);
+      std::vector<Prediction> expected = default_collector.collect_predictions(forest, data, data,
+          leaf_assignments, false, false);
+      std::vector<Prediction> actual = collector.collect_predictions(forest, data, data,
+          leaf_assignments, false, false);
+
+      REQUIRE(expected.size() == actual.size());
+      for (size_t sample = 0; sample < data.get_num_rows(); sample++) {
+        const std::vector<double>& expected_curve = expected[sample].get_predictions();
+        const std::vector<double>& actual_curve = actual[sample].get_predictions();
+        REQUIRE(expected_curve.size() == actual_curve.size());
+        for (size_t time = 0; time < num_failures; time++) {
+          if (std::isnan(expected_curve[time])) {
+            REQUIRE(std::isnan(actual_curve[time]));
+          } else {
+            REQUIRE(equal_doubles(expected_curve[time], actual_curve[time], 1e-10));
+          }
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,55 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include "prediction/collector/ValidTreesBySample.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+TEST_CASE("valid trees are scanned across word boundaries", "[prediction, unit]") {
+  size_t num_trees = 130;
+  ValidTreesBySample valid(3, num_trees, true);
+  for (size_t tree = 0; tree < num_trees; ++tree) {
+    if (tree != 5 && tree != 64 && tree != 129) {
+      valid.set_invalid(1, tree);
+    }
+  }
+
+  REQUIRE(valid.is_valid(0, 70));
+  REQUIRE(!valid.is_valid(1, 70));
+  REQUIRE(valid.is_valid(1, 64));
+
+  std::vector<size_t> trees;
+  for (size_t tree = valid.next(1, 0); tree < num_trees; tree = valid.next(1, tree + 1)) {
+    trees.push_back(tree);
+  }
+  REQUIRE(trees == std::vector<size_t>({5, 64, 129}));
+
+  size_t count = 0;
+  for (size_t tree = valid.next(2, 0); tree < num_trees; tree = valid.next(2, tree + 1)) {
+    count++;
+  }
+  REQUIRE(count == num_trees);
+}
+
+TEST_CASE("untracked valid trees include every tree", "[prediction, unit]") {
+  ValidTreesBySample valid(10, 3);
+  REQUIRE(valid.is_valid(9, 2));
+  REQUIRE(valid.next(4, 1) == 1);
+  REQUIRE(valid.next(4, 3) == 3);
+}
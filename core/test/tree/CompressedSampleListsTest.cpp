@@ -0,0 +1,53 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cstdint>
+
+#include "catch.hpp"
+#include "tree/CompressedSampleLists.h"
+
+using namespace grf;
+
+TEST_CASE("compressed sample lists round trip", "[tree, unit]") {
+  std::vector<std::vector<size_t>> lists = {{}, {3, 1, 4}, {}, {1, 5}, {9}};
+  CompressedSampleLists compressed(lists);
+
+  REQUIRE(compressed.size() == lists.size());
+  REQUIRE(compressed.to_vectors() == lists);
+  REQUIRE(compressed.get(0).empty());
+  REQUIRE(compressed.get(1).size() == 3);
+  REQUIRE(compressed.get(1)[2] == 4);
+
+  std::vector<size_t> iterated;
+  for (size_t sample : compressed.get(3)) {
+    iterated.push_back(sample);
+  }
+  REQUIRE(iterated == lists[3]);
+}
+
+TEST_CASE("compressed sample lists fall back to 64-bit ids", "[tree, unit]") {
+  size_t large_id = static_cast<size_t>(UINT32_MAX) + 5;
+  std::vector<std::vector<size_t>> lists = {{2}, {large_id, 7}};
+  CompressedSampleLists compressed(lists);
+
+  REQUIRE(compressed.to_vectors() == lists);
+  REQUIRE(compressed.get(1)[0] == large_id);
+
+  CompressedSampleLists single(std::vector<size_t>{large_id, 1});
+  REQUIRE(single.size() == 1);
+  REQUIRE(single.get(0).to_vector() == std::vector<size_t>({large_id, 1}));
+}
@@ -0,0 +1,137 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized-random-forest.
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <limits>
+
+#include "catch.hpp"
+#include "tree/Tree.h"
+
+using namespace grf;
+
+
+TEST_CASE("packed tree nodes round trip through the getters", "[tree, unit]") {
+  std::vector<std::vector<size_t>> child_nodes = {{1, 3, 0, 0, 0}, {2, 4, 0, 0, 0}};
+  std::vector<std::vector<size_t>> leaf_nodes = {{}, {}, {7}, {8}, {9}};
+  std::vector<size_t> split_vars = {4, 2, 0, 0, 0};
+  std::vector<double> split_values = {0.5, -1.25, 0, 0, 0};
+  std::vector<bool> send_missing_left = {false, true, true, true, true};
+  Tree tree(0, child_nodes, leaf_nodes, split_vars, split_values, {7, 8, 9},
+            send_missing_left, PredictionValues());
+
+  REQUIRE(tree.get_child_nodes() == child_nodes);
+  REQUIRE(tree.get_split_vars() == split_vars);
+  REQUIRE(tree.get_split_values() == split_values);
+  REQUIRE(tree.get_send_missing_left() == send_missing_left);
+
+  REQUIRE(tree.get_left_child(1) == 3);
+  REQUIRE(tree.get_right_child(1) == 4);
+  REQUIRE(tree.get_split_var(0) == 4);
+  REQUIRE(tree.get_split_value(1) == -1.25);
+  REQUIRE(tree.is_leaf(2));
+  REQUIRE(!tree.is_leaf(1));
+}
+
+TEST_CASE("compaction drops pruned nodes and preserves the tree", "[tree, unit]") {
+  // The tree from the pruning test, which prunes down to a root with leaves 6 and 7.
+  std::vector<std::vector<size_t>> child_nodes =
+      {{1, 3, 0, 5, 7, 0, 0, 0, 9, 0, 0}, {2, 4, 0, 6, 8, 0, 0, 0, 10, 0, 0}};
+  std::vector<std::vector<size_t>> leaf_nodes = {
+      {{}, {}, {}, {}, {}, {}, {42, 43}, {44}, {}, {}, {}}};
+  std::vector<std::vector<double>> values(11);
+  values[6] = {6.0};
+  values[7] = {7.0};
+  Tree tree(0, child_nodes, leaf_nodes, {0}, {0}, {0}, {true}, PredictionValues(values, 1));
+
+  tree.honesty_prune_leaves();
+  tree.compact();
+
+  REQUIRE(tree.get_root_node() == 0);
+  REQUIRE(tree.get_num_nodes() == 3);
+  REQUIRE(tree.get_left_child(0) == 1);
+  REQUIRE(tree.get_right_child(0) == 2);
+  REQUIRE(tree.get_leaf_samples(1).to_vector() == std::vector<size_t>({42, 43}));
+  REQUIRE(tree.get_leaf_samples(2).to_vector() == std::vector<size_t>({44}));
+  REQUIRE(tree.get_prediction_values().get(1, 0) == 6.0);
+  REQUIRE(tree.get_prediction_values().get(2, 0) == 7.0);
+}
+
+TEST_CASE("compaction lays out deep subtrees depth-first", "[tree, unit]") {
+  // A left-leaning chain deeper than the breadth-first levels.
+  size_t depth = 8;
+  size_t num_nodes = 2 * depth + 1;
+  std::vector<std::vector<size_t>> child_nodes(2, std::vector<size_t>(num_nodes, 0));
+  std::vector<std::vector<size_t>> leaf_nodes(num_nodes);
+  size_t node = 0;
+  for (size_t level = 0; level < depth; ++level) {
+    // Children are numbered right first, so creation order differs from the layout.
+    child_nodes[1][node] = 2 * level + 1;
+    child_nodes[0][node] = 2 * level + 2;
+    leaf_nodes[2 * level + 1] = {level};
+    node = 2 * level + 2;
+  }
+  leaf_nodes[node] = {depth};
+  Tree tree(0, child_nodes, leaf_nodes, {}, {}, {}, {}, PredictionValues());
+
+  tree.compact();
+
+  REQUIRE(tree.get_num_nodes() == num_nodes);
+  size_t current = tree.get_root_node();
+  for (size_t level = 0; level < depth; ++level) {
+    size_t left = tree.get_left_child(current);
+    size_t right = tree.get_right_child(current);
+    REQUIRE(tree.get_leaf_samples(right).to_vector() == std::vector<size_t>({level}));
+    if (level >= 4) {
+      // Below the breadth-first levels, a left descent reads the next node.
+      REQUIRE(left == current + 1);
+    }
+    current = left;
+  }
+  REQUIRE(tree.get_leaf_samples(current).to_vector() == std::vector<size_t>({depth}));
+}
+
+TEST_CASE("tiled traversal matches per-sample traversal", "[tree, unit]") {
+  // Splits on variable 2 (sending NaN right), then on variable 0 (sending NaN left).
+  std::vector<std::vector<size_t>> child_nodes = {{1, 3, 0, 0, 0}, {2, 4, 0, 0, 0}};
+  std::vector<std::vector<size_t>> leaf_nodes = {{}, {}, {0}, {1}, {2}};
+  Tree tree(0, child_nodes, leaf_nodes, {2, 0, 0, 0, 0}, {0.5, -1.0, 0, 0, 0}, {},
+            {false, true, true, true, true}, PredictionValues());
+
+  double nan = std::numeric_limits<double>::quiet_NaN();
+  std::vector<double> data_vec = {
+      // column 0
+      -2.0, 0.0, nan, -2.0, 3.0,
+      // column 1
+      9.0, 9.0, 9.0, 9.0, 9.0,
+      // column 2
+      0.1, 0.2, 0.3, nan, 0.9};
+  Data data(data_vec, 5, 3);
+  std::vector<size_t> expected = tree.find_leaf_nodes(data, std::vector<bool>(5, true));
+
+  // Gather columns 2 and 0 into a row-major tile, in that order.
+  std::vector<size_t> column_by_var = {1, 0, 0};
+  std::vector<double> tile;
+  for (size_t sample = 0; sample < 5; ++sample) {
+    tile.push_back(data.get(sample, 2));
+    tile.push_back(data.get(sample, 0));
+  }
+  std::vector<size_t> tile_samples = {0, 1, 2, 3, 4};
+  std::vector<size_t> actual;
+  tree.find_leaf_nodes(tile.data(), 2, column_by_var, tile_samples, actual);
+
+  REQUIRE(actual == expected);
+  REQUIRE(actual == std::vector<size_t>({3, 4, 3, 2, 2}));
+}
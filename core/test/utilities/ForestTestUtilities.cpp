@@ -16,6 +16,7 @@
  #-------------------------------------------------------------------------------*/
 
 #include "utilities/ForestTestUtilities.h"
+#include "commons/utility.h"
 #include "forest/ForestTrainer.h"
 
 ForestOptions ForestTestUtilities::default_options() {
@@ -28,12 +29,17 @@ ForestOptions ForestTestUtilities::default_honest_options() {
 
 ForestOptions ForestTestUtilities::default_options(bool honesty,
                                                    size_t ci_group_size) {
+  return default_options(honesty, ci_group_size, 1);
+}
+
+ForestOptions ForestTestUtilities::default_options(bool honesty,
+                                                   size_t ci_group_size,
+                                                   uint min_node_size) {
   double honesty_fraction = 0.5;
   bool prune = true;
   uint num_trees = 50;
   double sample_fraction = ci_group_size > 1 ? 0.35 : 0.7;
   uint mtry = 3;
-  uint min_node_size = 1;
   double alpha = 0.0;
   double imbalance_penalty = 0.0;
   std::vector<size_t> empty_clusters;
@@ -45,3 +51,9 @@ ForestOptions ForestTestUtilities::default_options(bool honesty,
           ci_group_size, sample_fraction, mtry, min_node_size, honesty, honesty_fraction,
       prune, alpha, imbalance_penalty, num_threads, seed, empty_clusters, samples_per_cluster);
 }
+
+GaussianDataFixture::GaussianDataFixture():
+    data_vec(load_data("test/forest/resources/gaussian_data.csv")),
+    data(data_vec) {
+  data.set_outcome_index(10);
+}
@@ -18,6 +18,10 @@
 #ifndef GRF_FORESTTESTUTILITIES_H
 #define GRF_FORESTTESTUTILITIES_H
 
+#include <utility>
+#include <vector>
+
+#include "commons/Data.h"
 #include "forest/ForestTrainer.h"
 
 using namespace grf;
@@ -28,6 +32,21 @@ public:
   static ForestOptions default_honest_options();
 
   static ForestOptions default_options(bool honesty, size_t ci_group_size);
+
+  static ForestOptions default_options(bool honesty, size_t ci_group_size, uint min_node_size);
+};
+
+/**
+ * A Catch fixture (for use with TEST_CASE_METHOD) holding the gaussian_data.csv training
+ * set, with the outcome in column 10. The fixture owns the values that data points into.
+ */
+class GaussianDataFixture {
+public:
+  GaussianDataFixture();
+
+protected:
+  std::pair<std::vector<double>, std::vector<size_t>> data_vec;
+  Data data;
 };
 
 #endif //GRF_FORESTTESTUTILITIES_H
@@ -19,11 +19,10 @@
 #include <vector>
 
 #include "Eigen/Sparse"
+#include "analysis/ForestWeightsComputer.h"
 #include "analysis/SplitFrequencyComputer.h"
 #include "commons/globals.h"
 #include "forest/Forest.h"
-#include "prediction/collector/SampleWeightComputer.h"
-#include "prediction/collector/TreeTraverser.h"
 
 #include "RcppUtilities.h"
 
@@ -59,28 +58,22 @@ Eigen::SparseMatrix<double> compute_sample_weights(const Rcpp::List& forest_obje
   Forest forest = RcppUtilities::deserialize_forest(forest_object);
   num_threads = ForestOptions::validate_num_threads(num_threads);
 
-  TreeTraverser tree_traverser(num_threads);
-  SampleWeightComputer weight_computer;
+  ForestWeightsComputer weights_computer(num_threads);
+  ForestWeights weights = weights_computer.compute(forest, train_data, data, oob_prediction);
 
-  std::vector<std::vector<size_t>> leaf_nodes_by_tree = tree_traverser.get_leaf_nodes(forest, data, oob_prediction);
-  std::vector<std::vector<bool>> trees_by_sample = tree_traverser.get_valid_trees_by_sample(forest, data, oob_prediction);
-
-  size_t num_samples = data.get_num_rows();
-  size_t num_neighbors = train_data.get_num_rows();
+  const std::vector<size_t>& row_offsets = weights.get_row_offsets();
+  const std::vector<size_t>& columns = weights.get_columns();
+  const std::vector<double>& values = weights.get_values();
 
   // From http://eigen.tuxfamily.org/dox/group__TutorialSparse.html:
   // Filling a sparse matrix effectively
   std::vector<Eigen::Triplet<double>> triplet_list;
-  triplet_list.reserve(num_neighbors);
-  Eigen::SparseMatrix<double> result(num_samples, num_neighbors);
-
-  for (size_t sample = 0; sample < num_samples; sample++) {
-    std::unordered_map<size_t, double> weights = weight_computer.compute_weights(
-        sample, forest, leaf_nodes_by_tree, trees_by_sample);
-    for (auto it = weights.begin(); it != weights.end(); it++) {
-      size_t neighbor = it->first;
-      double weight = it->second;
-      triplet_list.emplace_back(sample, neighbor, weight);
+  triplet_list.reserve(weights.get_num_nonzeros());
+  Eigen::SparseMatrix<double> result(weights.get_num_rows(), weights.get_num_cols());
+
+  for (size_t sample = 0; sample < weights.get_num_rows(); sample++) {
+    for (size_t index = row_offsets[sample]; index < row_offsets[sample + 1]; index++) {
+      triplet_list.emplace_back(sample, columns[index], values[index]);
     }
   }
   result.setFromTriplets(triplet_list.begin(), triplet_list.end());
@@ -18,6 +18,7 @@
 #include <Rcpp.h>
 #include <vector>
 
+#include "analysis/LambdaPathErrorComputer.h"
 #include "commons/globals.h"
 #include "forest/ForestPredictors.h"
 #include "forest/ForestTrainers.h"
@@ -45,6 +46,7 @@ Rcpp::List causal_train(const Rcpp::NumericMatrix& train_matrix,
                         bool stabilize_splits,
                         std::vector<size_t> clusters,
                         unsigned int samples_per_cluster,
+                        bool keep_leaf_samples,
                         bool compute_oob_predictions,
                         unsigned int num_threads,
                         unsigned int seed) {
@@ -59,7 +61,8 @@ Rcpp::List causal_train(const Rcpp::NumericMatrix& train_matrix,
   }
 
   ForestOptions options(num_trees, ci_group_size, sample_fraction, mtry, min_node_size, honesty,
-                        honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, clusters, samples_per_cluster);
+                        honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, clusters, samples_per_cluster,
+                        keep_leaf_samples);
   Forest forest = trainer.train(data, options);
 
   std::vector<Prediction> predictions;
@@ -168,3 +171,31 @@ Rcpp::List ll_causal_predict_oob(const Rcpp::List& forest_object,
 
   return result;
 }
+
+// [[Rcpp::export]]
+Rcpp::List ll_causal_tune(const Rcpp::List& forest_object,
+                          const Rcpp::NumericMatrix& train_matrix,
+                          size_t outcome_index,
+                          size_t treatment_index,
+                          std::vector<double> ll_lambda,
+                          bool ll_weight_penalty,
+                          std::vector<size_t> linear_correction_variables,
+                          unsigned int num_threads) {
+  Data data = RcppUtilities::convert_data(train_matrix);
+
+  data.set_outcome_index(outcome_index);
+  data.set_treatment_index(treatment_index);
+  data.set_instrument_index(treatment_index);
+
+  Forest deserialized_forest = RcppUtilities::deserialize_forest(forest_object);
+
+  ForestPredictor predictor = ll_causal_predictor(num_threads, ll_lambda, ll_weight_penalty,
+                                                  linear_correction_variables);
+  std::vector<Prediction> predictions = predictor.predict_oob(deserialized_forest, data, false);
+  std::vector<double> errors = LambdaPathErrorComputer().compute_r_learner_errors(predictions, data);
+
+  Rcpp::List result;
+  result.push_back(RcppUtilities::create_prediction_matrix(predictions), "predictions");
+  result.push_back(errors, "errors");
+  return result;
+}
@@ -41,6 +41,7 @@ Rcpp::List multi_regression_train(const Rcpp::NumericMatrix& train_matrix,
                                   double imbalance_penalty,
                                   std::vector<size_t>& clusters,
                                   unsigned int samples_per_cluster,
+                                  bool keep_leaf_samples,
                                   bool compute_oob_predictions,
                                   unsigned int num_threads,
                                   unsigned int seed) {
@@ -52,7 +53,8 @@ Rcpp::List multi_regression_train(const Rcpp::NumericMatrix& train_matrix,
 
   size_t ci_group_size = 1;
   ForestOptions options(num_trees, ci_group_size, sample_fraction, mtry, min_node_size, honesty,
-      honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, clusters, samples_per_cluster);
+      honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, clusters, samples_per_cluster,
+      keep_leaf_samples);
   ForestTrainer trainer = multi_regression_trainer(data.get_num_outcomes());
   Forest forest = trainer.train(data, options);
 
@@ -43,6 +43,7 @@ Rcpp::List probability_train(const Rcpp::NumericMatrix& train_matrix,
                              double imbalance_penalty,
                              const std::vector<size_t>& clusters,
                              unsigned int samples_per_cluster,
+                             bool keep_leaf_samples,
                              bool compute_oob_predictions,
                              int num_threads,
                              unsigned int seed) {
@@ -55,7 +56,8 @@ Rcpp::List probability_train(const Rcpp::NumericMatrix& train_matrix,
   }
 
   ForestOptions options(num_trees, ci_group_size, sample_fraction, mtry, min_node_size, honesty,
-      honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, clusters, samples_per_cluster);
+      honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, clusters, samples_per_cluster,
+      keep_leaf_samples);
   Forest forest = trainer.train(data, options);
 
   std::vector<Prediction> predictions;
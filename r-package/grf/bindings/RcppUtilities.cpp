@@ -16,6 +16,7 @@
  #-------------------------------------------------------------------------------*/
 
 #include <Rcpp.h>
+#include <algorithm>
 
 #include "commons/Data.h"
 #include "forest/ForestOptions.h"
@@ -42,7 +43,12 @@ Forest RcppUtilities::deserialize_forest(const Rcpp::List& forest_object) {
 
   Rcpp::List root_nodes = forest_object["_root_nodes"];
   Rcpp::List child_nodes = forest_object["_child_nodes"];
-  Rcpp::List leaf_samples = forest_object["_leaf_samples"];
+  // Forests trained without keeping their leaf samples are serialized without them.
+  bool has_leaf_samples = forest_object.containsElementNamed("_leaf_samples");
+  Rcpp::List leaf_samples;
+  if (has_leaf_samples) {
+    leaf_samples = forest_object["_leaf_samples"];
+  }
   Rcpp::List split_vars = forest_object["_split_vars"];
   Rcpp::List split_values = forest_object["_split_values"];
   Rcpp::List drawn_samples = forest_object["_drawn_samples"];
@@ -52,13 +58,25 @@ Forest RcppUtilities::deserialize_forest(const Rcpp::List& forest_object) {
   size_t num_types = forest_object["_pv_num_types"];
 
   for (size_t t = 0; t < num_trees; t++) {
+    // Forests are serialized with sorted drawn samples, but objects saved by older
+    // versions of the package may not be.
+    std::vector<size_t> tree_drawn_samples = drawn_samples.at(t);
+    if (!std::is_sorted(tree_drawn_samples.begin(), tree_drawn_samples.end())) {
+      std::sort(tree_drawn_samples.begin(), tree_drawn_samples.end());
+    }
+
+    std::vector<std::vector<size_t>> tree_leaf_samples;
+    if (has_leaf_samples) {
+      tree_leaf_samples = Rcpp::as<std::vector<std::vector<size_t>>>(leaf_samples.at(t));
+    }
+
     trees.emplace_back(new Tree(
                          root_nodes.at(t),
                          child_nodes.at(t),
-                         leaf_samples.at(t),
+                         tree_leaf_samples,
                          split_vars.at(t),
                          split_values.at(t),
-                         drawn_samples.at(t),
+                         tree_drawn_samples,
                          send_missing_left.at(t),
                          PredictionValues(prediction_values.at(t), num_types)));
   }
@@ -67,6 +85,11 @@ Forest RcppUtilities::deserialize_forest(const Rcpp::List& forest_object) {
 }
 
 Rcpp::List RcppUtilities::serialize_forest(Forest& forest) {
+  // Tree seeds are not serialized, so the drawn samples could not be recovered.
+  if (forest.get_drawn_sample_regenerator() != nullptr) {
+    throw std::runtime_error("Forests whose drawn samples have been discarded cannot be serialized.");
+  }
+
   Rcpp::List result;
 
   result.push_back(forest.get_ci_group_size(), "_ci_group_size");
@@ -75,6 +98,13 @@ Rcpp::List RcppUtilities::serialize_forest(Forest& forest) {
   size_t num_trees = forest.get_trees().size();
   result.push_back(num_trees, "_num_trees");
 
+  // Leaf samples are only shipped if every tree kept them, so that forests trained without
+  // them (or merged with such forests) keep failing clearly in tools that need them.
+  bool has_leaf_samples = true;
+  for (const auto& tree : forest.get_trees()) {
+    has_leaf_samples = has_leaf_samples && tree->has_leaf_samples();
+  }
+
   Rcpp::List root_nodes(num_trees);
   Rcpp::List child_nodes(num_trees);
   Rcpp::List leaf_samples(num_trees);
@@ -90,10 +120,12 @@ Rcpp::List RcppUtilities::serialize_forest(Forest& forest) {
     std::unique_ptr<Tree> tree = std::move(forest.get_trees_().at(t));
     root_nodes[t] = tree->get_root_node();
     child_nodes[t] = tree->get_child_nodes();
-    leaf_samples[t] = tree->get_leaf_samples();
+    if (has_leaf_samples) {
+      leaf_samples[t] = tree->get_leaf_samples();
+    }
     split_vars[t] = tree->get_split_vars();
     split_values[t] = tree->get_split_values();
-    drawn_samples[t] = tree->get_drawn_samples();
+    drawn_samples[t] = tree->get_drawn_samples().to_vector();
     send_missing_left[t] = tree->get_send_missing_left();
 
     prediction_values[t] = tree->get_prediction_values().get_all_values();
@@ -102,7 +134,9 @@ Rcpp::List RcppUtilities::serialize_forest(Forest& forest) {
 
   result.push_back(root_nodes, "_root_nodes");
   result.push_back(child_nodes, "_child_nodes");
-  result.push_back(leaf_samples, "_leaf_samples");
+  if (has_leaf_samples) {
+    result.push_back(leaf_samples, "_leaf_samples");
+  }
   result.push_back(split_vars, "_split_vars");
   result.push_back(split_values, "_split_values");
   result.push_back(drawn_samples, "_drawn_samples");
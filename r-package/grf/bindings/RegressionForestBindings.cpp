@@ -18,6 +18,7 @@
 #include <Rcpp.h>
 #include <vector>
 
+#include "analysis/LambdaPathErrorComputer.h"
 #include "commons/globals.h"
 #include "forest/ForestPredictors.h"
 #include "forest/ForestTrainers.h"
@@ -42,6 +43,7 @@ Rcpp::List regression_train(const Rcpp::NumericMatrix& train_matrix,
                             double imbalance_penalty,
                             std::vector<size_t> clusters,
                             unsigned int samples_per_cluster,
+                            bool keep_leaf_samples,
                             bool compute_oob_predictions,
                             unsigned int num_threads,
                             unsigned int seed) {
@@ -54,7 +56,8 @@ Rcpp::List regression_train(const Rcpp::NumericMatrix& train_matrix,
   }
 
   ForestOptions options(num_trees, ci_group_size, sample_fraction, mtry, min_node_size, honesty,
-      honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, clusters, samples_per_cluster);
+      honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, clusters, samples_per_cluster,
+      keep_leaf_samples);
   Forest forest = trainer.train(data, options);
 
   std::vector<Prediction> predictions;
@@ -184,3 +187,27 @@ Rcpp::List ll_regression_predict_oob(const Rcpp::List& forest_object,
 
   return result;
 }
+
+// [[Rcpp::export]]
+Rcpp::List ll_regression_tune(const Rcpp::List& forest_object,
+                              const Rcpp::NumericMatrix& train_matrix,
+                              size_t outcome_index,
+                              std::vector<double> ll_lambda,
+                              bool ll_weight_penalty,
+                              std::vector<size_t> linear_correction_variables,
+                              unsigned int num_threads) {
+  Data data = RcppUtilities::convert_data(train_matrix);
+  data.set_outcome_index(outcome_index);
+
+  Forest deserialized_forest = RcppUtilities::deserialize_forest(forest_object);
+
+  ForestPredictor predictor = ll_regression_predictor(num_threads,
+      ll_lambda, ll_weight_penalty, linear_correction_variables);
+  std::vector<Prediction> predictions = predictor.predict_oob(deserialized_forest, data, false);
+  std::vector<double> errors = LambdaPathErrorComputer().compute_regression_errors(predictions, data);
+
+  Rcpp::List result;
+  result.push_back(RcppUtilities::create_prediction_matrix(predictions), "predictions");
+  result.push_back(errors, "errors");
+  return result;
+}